@@ -0,0 +1,64 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/sax.hpp"
+
+using namespace jsonlib;
+
+auto make_document(std::size_t records) -> std::string {
+    std::string out{"["};
+    for (std::size_t i = 0; i < records; i++) {
+        if (i != 0) {
+            out += ", ";
+        }
+        out += R"({"id": )" + std::to_string(i) + R"(, "status": )"
+               + (i % 7 == 0 ? "500" : "200") + R"(, "path": "/api/v1/items/)"
+               + std::to_string(i) + R"(", "latency": 0.)"
+               + std::to_string(i % 1000) + "}";
+    }
+    out += ']';
+    return out;
+}
+
+// Counts records with status 500 without building a tree.
+struct ErrorCounter : EventHandler {
+    using EventHandler::on_number;
+
+    std::size_t errors = 0;
+    bool        in_status = false;
+
+    auto on_key(std::string_view key) -> void {
+        in_status = key == "status";
+    }
+    auto on_number(std::int64_t value) -> void {
+        errors += in_status && value == 500 ? 1 : 0;
+    }
+};
+
+template <typename Fn>
+auto throughput(std::string_view input, Fn fn) -> double {
+    constexpr int rounds = 20;
+    auto          start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        fn();
+    }
+    std::chrono::duration<double> elapsed
+        = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(input.size()) * rounds / elapsed.count() / 1e6;
+}
+
+auto main() -> int {
+    auto input = make_document(100000);
+
+    auto dom = throughput(input, [&] { auto obj = Json::deserialize(input); });
+    auto events = throughput(input, [&] {
+        ErrorCounter counter;
+        parse_events(input, counter);
+    });
+    PRINT_FMT("dom {:>7.1f} MB/s, events {:>7.1f} MB/s\n", dom, events);
+}
@@ -0,0 +1,67 @@
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/mapped_file.hpp"
+
+using namespace jsonlib;
+
+// ~10 MB of reference data.
+auto make_document() -> std::string {
+    std::string out{"["};
+    for (std::size_t i = 0; i < 100000; i++) {
+        if (i != 0) {
+            out += ",\n";
+        }
+        out += R"({"code": "C)" + std::to_string(i)
+               + R"(", "label": "reference entry", "rate": 0.125,)"
+                 R"( "aliases": ["a", "b"], "active": true})";
+    }
+    out += "]";
+    return out;
+}
+
+template <typename Fn>
+auto milliseconds(Fn fn) -> double {
+    constexpr int rounds = 5;
+    auto          start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        fn();
+    }
+    std::chrono::duration<double, std::milli> elapsed
+        = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / rounds;
+}
+
+auto main() -> int {
+    auto path = (std::filesystem::temp_directory_path() / "bench_file.json")
+                    .string();
+    {
+        std::ofstream out{path, std::ios::binary};
+        out << make_document();
+    }
+
+    auto read = milliseconds([&] {
+        std::ifstream in{path, std::ios::binary};
+        std::string   content{std::istreambuf_iterator<char>{in}, {}};
+        auto          obj = Json::deserialize(content);
+    });
+    auto mapped
+        = milliseconds([&] { auto obj = deserialize_file(path); });
+    auto borrowed = milliseconds([&] {
+        MappedFile file{path};
+        auto obj = Json::deserialize(file.view(), {.borrow_strings = true});
+    });
+    PRINT_FMT("{} MB: read + parse {:.1f} ms, deserialize_file {:.1f} ms, "
+              "mapped with borrowed strings {:.1f} ms\n",
+              std::filesystem::file_size(path) / 1000000,
+              read,
+              mapped,
+              borrowed);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,59 @@
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/lazy.hpp"
+
+using namespace jsonlib;
+
+// A ~50 KB request body whose routing fields come after a large payload.
+auto make_document() -> std::string {
+    std::string out{R"({"payload": [)"};
+    for (std::size_t i = 0; i < 500; i++) {
+        if (i != 0) {
+            out += ", ";
+        }
+        out += R"({"id": )" + std::to_string(i)
+               + R"(, "name": "item \"quoted\" )" + std::to_string(i)
+               + R"(", "price": 12.5, "tags": ["x", "y"]})";
+    }
+    out += R"(], "route": "/orders", "tenant": 42, "trace": "abc123"})";
+    return out;
+}
+
+template <typename Fn>
+auto latency(Fn fn) -> double {
+    constexpr int rounds = 2000;
+    auto          start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        fn();
+    }
+    std::chrono::duration<double, std::micro> elapsed
+        = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / rounds;
+}
+
+auto main() -> int {
+    auto        input = make_document();
+    std::size_t sink = 0;
+
+    auto full = latency([&] {
+        auto obj = Json::deserialize(input);
+        sink += obj["route"].string().size() + obj["tenant"].int64()
+                + obj["trace"].string().size();
+    });
+    auto lazy = latency([&] {
+        auto doc = LazyJson::parse(input);
+        sink += doc["route"].string().size() + doc["tenant"].int64()
+                + doc["trace"].string().size();
+    });
+    PRINT_FMT("{} bytes, 3 fields: full parse {:>7.1f} us, lazy {:>7.1f} us "
+              "({})\n",
+              input.size(),
+              full,
+              lazy,
+              sink);
+}
@@ -0,0 +1,45 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <thread>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/ndjson.hpp"
+
+using namespace jsonlib;
+
+// 200k log records, ~30 MB.
+auto make_lines() -> std::string {
+    std::string out;
+    for (std::size_t i = 0; i < 200000; i++) {
+        out += R"({"ts": 1700000000)" + std::to_string(i)
+               + R"(, "level": "info", "msg": "request \"served\"", )"
+                 R"("latency_ms": 12.75, "tags": ["api", "v2"], "user": )"
+                 R"({"id": )"
+               + std::to_string(i % 977) + R"(, "admin": false}})" + '\n';
+    }
+    return out;
+}
+
+auto main() -> int {
+    auto        input = make_lines();
+    std::size_t sink = 0;
+
+    double single = 0;
+    for (unsigned threads = 1;
+         threads <= std::max(std::thread::hardware_concurrency(), 1U);
+         threads *= 2) {
+        auto start = std::chrono::steady_clock::now();
+        auto values = parse_ndjson(input, {.threads = threads});
+        std::chrono::duration<double> elapsed
+            = std::chrono::steady_clock::now() - start;
+        sink += values.size();
+        single = threads == 1 ? elapsed.count() : single;
+        PRINT_FMT("{:>2} threads: {:>7.1f} MB/s, speedup {:.2f}x\n",
+                  threads,
+                  static_cast<double>(input.size()) / elapsed.count() / 1e6,
+                  single / elapsed.count());
+    }
+    PRINT_FMT("({})\n", sink);
+}
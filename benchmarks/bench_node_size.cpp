@@ -0,0 +1,97 @@
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <string_view>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/document.hpp"
+#include "jsonlib/jsonlib.hpp"
+
+using namespace jsonlib;
+
+// Every allocation carries a small header with its size, so that the bytes
+// still alive after a parse can be reported (not just the bytes requested).
+namespace {
+constexpr std::size_t header_size = alignof(std::max_align_t);
+
+std::size_t live_bytes = 0;
+std::size_t live_allocations = 0;
+} // namespace
+
+auto operator new(std::size_t size) -> void * {
+    auto *base = static_cast<char *>(std::malloc(size + header_size));
+    if (base == nullptr) {
+        throw std::bad_alloc{};
+    }
+    *reinterpret_cast<std::size_t *>(base) = size;
+    live_bytes += size;
+    live_allocations++;
+    return base + header_size;
+}
+
+auto operator delete(void *ptr) noexcept -> void {
+    if (ptr == nullptr) {
+        return;
+    }
+    auto *base = static_cast<char *>(ptr) - header_size;
+    live_bytes -= *reinterpret_cast<std::size_t *>(base);
+    live_allocations--;
+    std::free(base);
+}
+
+auto operator delete(void *ptr, [[maybe_unused]] std::size_t size) noexcept
+    -> void {
+    operator delete(ptr);
+}
+
+auto make_array(std::string_view element, std::size_t n) -> std::string {
+    std::string out{"["};
+    for (std::size_t i = 0; i < n; i++) {
+        if (i != 0) {
+            out += ", ";
+        }
+        out += element;
+    }
+    out += "]";
+    return out;
+}
+
+template <typename Parse>
+auto measure(std::string_view name, std::string_view element, Parse parse) {
+    constexpr std::size_t n = 100000;
+    auto                  input = make_array(element, n);
+
+    auto bytes = live_bytes;
+    auto allocations = live_allocations;
+    auto obj = parse(input);
+    bytes = live_bytes - bytes;
+    allocations = live_allocations - allocations;
+
+    PRINT_FMT("{:<8} {:>8.1f} bytes/node {:>6.2f} allocations/node\n",
+              name,
+              static_cast<double>(bytes) / n,
+              static_cast<double>(allocations) / n);
+}
+
+template <typename Parse>
+auto measure_all(std::string_view title, Parse parse) {
+    PRINT_FMT("{}:\n", title);
+    measure("null", "null", parse);
+    measure("true", "true", parse);
+    measure("number", "3.14", parse);
+    measure("string", R"("hello")", parse);
+    measure("object", R"({"k": 1})", parse);
+}
+
+auto main() -> int {
+    measure_all("Json", [](std::string_view in) {
+        return Json::deserialize(in);
+    });
+    measure_all("Json, borrowed strings", [](std::string_view in) {
+        return Json::deserialize(in, {.borrow_strings = true});
+    });
+    measure_all("Document", [](std::string_view in) {
+        return Document::parse(in);
+    });
+}
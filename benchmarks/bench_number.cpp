@@ -0,0 +1,69 @@
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+
+using namespace jsonlib;
+
+// Metrics-like integer samples and geo coordinate pairs.
+auto make_integers(std::size_t count) -> std::string {
+    std::string out{"["};
+    for (std::size_t i = 0; i < count; i++) {
+        if (i != 0) {
+            out += ", ";
+        }
+        out += std::to_string(1721286639909 + i * 7919);
+    }
+    out += ']';
+    return out;
+}
+
+auto make_coordinates(std::size_t count) -> std::string {
+    std::string out{"["};
+    for (std::size_t i = 0; i < count; i++) {
+        if (i != 0) {
+            out += ", ";
+        }
+        out += "[" + std::to_string(116.391 + static_cast<double>(i) * 1e-5)
+               + ", " + std::to_string(-39.907 - static_cast<double>(i) * 1e-5)
+               + "]";
+    }
+    out += ']';
+    return out;
+}
+
+template <typename Fn>
+auto throughput(std::string_view input, Fn fn) -> double {
+    constexpr int rounds = 20;
+    auto          start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        fn();
+    }
+    std::chrono::duration<double> elapsed
+        = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(input.size()) * rounds / elapsed.count() / 1e6;
+}
+
+auto main() -> int {
+    constexpr std::size_t count = 200000;
+
+    for (auto [name, input] : {std::pair{"integers", make_integers(count)},
+                               std::pair{"coordinates",
+                                         make_coordinates(count)}}) {
+        auto obj = Json::deserialize(input);
+        auto parse = throughput(input, [&] {
+            auto parsed = Json::deserialize(input);
+        });
+        auto serialize = throughput(input, [&] {
+            auto text = obj.serialize();
+        });
+        PRINT_FMT("{:<12} {:>7.1f} MB/s parse, {:>7.1f} MB/s serialize\n",
+                  name,
+                  parse,
+                  serialize);
+    }
+}
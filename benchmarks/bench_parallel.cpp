@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <thread>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/parallel.hpp"
+
+using namespace jsonlib;
+
+// One ~40 MB top-level array of 200k objects.
+auto make_export() -> std::string {
+    std::string out{"["};
+    for (std::size_t i = 0; i < 200000; i++) {
+        if (i != 0) {
+            out += ",\n";
+        }
+        out += R"({"id": )" + std::to_string(i)
+               + R"(, "name": "item \"quoted\" )" + std::to_string(i)
+               + R"(", "price": 12.5, "tags": ["x", "y", "z"],)"
+                 R"( "owner": {"first": "Ada", "last": "Lovelace"}})";
+    }
+    out += "]";
+    return out;
+}
+
+template <typename Fn>
+auto seconds(Fn fn) -> double {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double> elapsed
+        = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+auto main() -> int {
+    auto input = make_export();
+    auto mb = static_cast<double>(input.size()) / 1e6;
+
+    auto direct = seconds([&] { auto obj = Json::deserialize(input); });
+    PRINT_FMT("deserialize:          {:>7.1f} MB/s\n", mb / direct);
+    for (unsigned threads = 1;
+         threads <= std::max(std::thread::hardware_concurrency(), 1U);
+         threads *= 2) {
+        auto elapsed = seconds([&] {
+            auto obj = deserialize_parallel(input, {.threads = threads});
+        });
+        PRINT_FMT("{:>2} threads:           {:>7.1f} MB/s, speedup {:.2f}x\n",
+                  threads,
+                  mb / elapsed,
+                  direct / elapsed);
+    }
+}
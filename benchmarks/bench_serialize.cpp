@@ -0,0 +1,47 @@
+#include <array>
+#include <chrono>
+#include <sstream>
+#include <string>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+
+using namespace jsonlib;
+
+// Average nanoseconds per call of `fn` on a small response-sized object.
+template <typename Fn>
+auto latency(Fn fn) -> double {
+    constexpr int rounds = 1000000;
+    auto          start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        fn();
+    }
+    std::chrono::duration<double, std::nano> elapsed
+        = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / rounds;
+}
+
+auto main() -> int {
+    auto obj = Json::deserialize(R"({"status": 200, "id": 12345, )"
+                                 R"("user": "alice", "tags": ["a", "b"], )"
+                                 R"("score": 0.5})");
+
+    std::string           reused;
+    std::array<char, 256> buffer;
+    std::ostringstream    stream;
+
+    PRINT_FMT("serialize():            {:>6.1f} ns\n",
+              latency([&] { auto out = obj.serialize(); }));
+    PRINT_FMT("serialize_to(string&):  {:>6.1f} ns\n", latency([&] {
+                  reused.clear();
+                  obj.serialize_to(reused);
+              }));
+    PRINT_FMT("BufferWriter:           {:>6.1f} ns\n", latency([&] {
+                  BufferWriter writer{buffer};
+                  obj.serialize_to(writer);
+              }));
+    PRINT_FMT("serialize_to(ostream&): {:>6.1f} ns\n", latency([&] {
+                  stream.str({});
+                  obj.serialize_to(stream);
+              }));
+}
@@ -0,0 +1,44 @@
+#include <chrono>
+#include <string_view>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/static_json.hpp"
+
+using namespace jsonlib;
+
+#define DEFAULTS                                                               \
+    R"({"service": "gateway", "port": 8080, "retries": 3, "timeout": 2.5,)"   \
+    R"( "hosts": ["a.example", "b.example", "c.example"],)"                    \
+    R"( "limits": {"body": 1048576, "headers": 64, "rate": 0.75},)"            \
+    R"( "tls": {"enabled": true, "ciphers": ["TLS_AES_128_GCM_SHA256",)"       \
+    R"( "TLS_AES_256_GCM_SHA384"], "min_version": "1.2"}, "proxy": null})"
+
+constexpr std::string_view defaults_text = DEFAULTS;
+constexpr auto             defaults = static_json<DEFAULTS>.root();
+
+// Average nanoseconds per call of `fn`.
+template <typename Fn>
+auto latency(Fn fn) -> double {
+    constexpr int rounds = 1000000;
+    auto          start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        fn();
+    }
+    std::chrono::duration<double, std::nano> elapsed
+        = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / rounds;
+}
+
+auto main() -> int {
+    // What reading one setting costs, starting from the literal.
+    double sum = 0;
+    PRINT_FMT("Json::deserialize + lookup: {:>7.1f} ns\n", latency([&] {
+                  auto obj = Json::deserialize(defaults_text);
+                  sum += obj["limits"]["rate"].number();
+              }));
+    PRINT_FMT("static_json lookup:         {:>7.1f} ns\n",
+              latency([&] { sum += defaults["limits"]["rate"].number(); }));
+    PRINT_FMT("static_json size: {} bytes\n", sizeof(static_json<DEFAULTS>));
+    return sum == 1500000 ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+
+using namespace jsonlib;
+
+// An array of log-line sized strings; every `escape_every`-th line carries
+// escape sequences.
+auto make_document(std::size_t lines, std::size_t escape_every)
+    -> std::string {
+    std::string out{"["};
+    for (std::size_t i = 0; i < lines; i++) {
+        if (i != 0) {
+            out += ", ";
+        }
+        out += R"("2024-07-18 15:10:39.909 INFO request )";
+        out += std::to_string(i);
+        if (escape_every != 0 && i % escape_every == 0) {
+            out += R"( from \"client\"\n\tuser-agent: \"curl/8.0\")";
+        } else {
+            out += " completed in 12ms with status 200 and 512 bytes";
+        }
+        out += '"';
+    }
+    out += ']';
+    return out;
+}
+
+auto throughput(std::string_view input, const ParseOptions &options)
+    -> double {
+    constexpr int rounds = 20;
+    auto          start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        auto obj = Json::deserialize(input, options);
+    }
+    std::chrono::duration<double> elapsed
+        = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(input.size()) * rounds / elapsed.count() / 1e6;
+}
+
+auto serialize_throughput(std::string_view input) -> double {
+    constexpr int rounds = 20;
+    auto          obj = Json::deserialize(input);
+    std::string   out;
+    auto          start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        out.clear();
+        obj.serialize_to(out);
+    }
+    std::chrono::duration<double> elapsed
+        = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(out.size()) * rounds / elapsed.count() / 1e6;
+}
+
+auto main() -> int {
+    constexpr std::size_t lines = 50000;
+
+    for (std::size_t escape_every : {0, 10, 1}) {
+        auto input = make_document(lines, escape_every);
+        PRINT_FMT("escapes every {} lines: {:>7.1f} MB/s copied, {:>7.1f} "
+                  "MB/s borrowed, {:>7.1f} MB/s serialized\n",
+                  escape_every,
+                  throughput(input, {}),
+                  throughput(input, {.borrow_strings = true}),
+                  serialize_throughput(input));
+    }
+}
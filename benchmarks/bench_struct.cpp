@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/reflect.hpp"
+
+using namespace jsonlib;
+
+struct Response {
+    int                      status;
+    std::uint64_t            id;
+    std::string              user;
+    std::vector<std::string> tags;
+    double                   score;
+};
+JSONLIB_REFLECT(Response, status, id, user, tags, score)
+
+// Average nanoseconds per call of `fn` on a small response-sized object.
+template <typename Fn>
+auto latency(Fn fn) -> double {
+    constexpr int rounds = 1000000;
+    auto          start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        fn();
+    }
+    std::chrono::duration<double, std::nano> elapsed
+        = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / rounds;
+}
+
+auto main() -> int {
+    Response    response{200, 12345, "alice", {"a", "b"}, 0.5};
+    std::string reused;
+
+    PRINT_FMT("Json tree + serialize_to: {:>6.1f} ns\n", latency([&] {
+                  Json obj;
+                  obj["status"] = response.status;
+                  obj["id"] = response.id;
+                  obj["user"] = response.user;
+                  obj["tags"] = {response.tags[0], response.tags[1]};
+                  obj["score"] = response.score;
+                  reused.clear();
+                  obj.serialize_to(reused);
+              }));
+    PRINT_FMT("reflected serialize_to:   {:>6.1f} ns\n", latency([&] {
+                  reused.clear();
+                  serialize_to(reused, response);
+              }));
+    ASSERT(Json::deserialize(reused)["user"].string() == "alice");
+
+    // The tree alone, before reading anything out of it.
+    PRINT_FMT("Json::deserialize:        {:>6.1f} ns\n",
+              latency([&] { auto obj = Json::deserialize(reused); }));
+    PRINT_FMT("read<Response>:           {:>6.1f} ns\n",
+              latency([&] { response = read<Response>(reused); }));
+    ASSERT(response.user == "alice" && response.tags[1] == "b");
+}
@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/structural_index.hpp"
+
+using namespace jsonlib;
+
+// ~1 MB of records mixing nesting, escapes and whitespace.
+auto make_document() -> std::string {
+    std::string out{"[\n"};
+    for (std::size_t i = 0; i < 10000; i++) {
+        if (i != 0) {
+            out += ",\n";
+        }
+        out += R"(  {"id": )" + std::to_string(i)
+               + R"(, "name": "item \"quoted\" \\ )" + std::to_string(i)
+               + R"(", "price": 12.5, "active": true, "tags": ["x", "y"],)"
+                 R"( "owner": {"first": "Ada", "last": "Lovelace"}})";
+    }
+    out += "\n]";
+    return out;
+}
+
+template <typename Fn>
+auto throughput(const std::string &input, Fn fn) -> double {
+    constexpr int rounds = 50;
+    auto          start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        fn();
+    }
+    std::chrono::duration<double> elapsed
+        = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(input.size()) * rounds / elapsed.count() / 1e6;
+}
+
+auto main() -> int {
+    auto        input = make_document();
+    std::size_t sink = 0;
+
+    auto stage1 = throughput(input, [&] {
+        sink += StructuralIndex::build(input).size();
+    });
+    auto direct = throughput(input, [&] {
+        auto obj = Json::deserialize(input);
+    });
+    auto two_stage = throughput(input, [&] {
+        auto index = StructuralIndex::build(input);
+        auto obj = Json::deserialize(input, index);
+    });
+    PRINT_FMT("{} bytes: stage 1 {:>7.1f} MB/s, direct parse {:>7.1f} MB/s, "
+              "two-stage parse {:>7.1f} MB/s ({})\n",
+              input.size(),
+              stage1,
+              direct,
+              two_stage,
+              sink);
+}
@@ -0,0 +1,61 @@
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/utf8.hpp"
+
+using namespace jsonlib;
+
+// ~10 MB of request bodies with some non-ASCII text.
+auto make_document() -> std::string {
+    std::string out{"["};
+    for (std::size_t i = 0; i < 100000; i++) {
+        if (i != 0) {
+            out += ",\n";
+        }
+        out += R"({"id": )" + std::to_string(i)
+               + R"(, "name": "Zoë Ångström", "city": "東京",)"
+                 R"( "tags": ["a", "b\n"], "score": 0.5, "ok": true})";
+    }
+    out += "]";
+    return out;
+}
+
+template <typename Fn>
+auto milliseconds(Fn fn) -> double {
+    constexpr int rounds = 5;
+    auto          start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        fn();
+    }
+    std::chrono::duration<double, std::milli> elapsed
+        = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / rounds;
+}
+
+auto main() -> int {
+    auto document = make_document();
+    auto mb = static_cast<double>(document.size()) / 1e6;
+    // Read through volatile and counted, so that the checks are neither
+    // hoisted out of the loop nor optimized away.
+    const char *volatile data = document.data();
+    const auto          *last = document.data() + document.size();
+    int                  valid = 0;
+
+    auto utf8
+        = milliseconds([&] { valid += simd::is_valid_utf8(data, last); });
+    auto utf8_scalar = milliseconds(
+        [&] { valid += simd::detail::is_valid_utf8_scalar(data, last); });
+    auto validate = milliseconds([&] { valid += Json::validate(document); });
+    auto parse = milliseconds([&] { auto obj = Json::deserialize(document); });
+    PRINT_FMT("{:.1f} MB: UTF-8 {:.0f} MB/s (scalar {:.0f} MB/s), validate "
+              "{:.0f} MB/s, deserialize {:.0f} MB/s\n",
+              mb,
+              mb / utf8 * 1000,
+              mb / utf8_scalar * 1000,
+              mb / validate * 1000,
+              mb / parse * 1000);
+    return valid == 15 ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/simd.hpp"
+
+using namespace jsonlib;
+
+// Builds the same array of records either minified (`indent` == 0) or
+// pretty-printed with `indent` spaces per level.
+auto make_document(std::size_t records, std::size_t indent) -> std::string {
+    std::string out;
+    auto        newline = [&](std::size_t level) {
+        if (indent != 0) {
+            out += '\n';
+            out.append(level * indent, ' ');
+        }
+    };
+    auto colon = indent != 0 ? std::string_view{": "} : std::string_view{":"};
+
+    out += '[';
+    for (std::size_t i = 0; i < records; i++) {
+        newline(1);
+        out += '{';
+        newline(2);
+        out += R"("id")";
+        out += colon;
+        out += std::to_string(i);
+        out += ',';
+        newline(2);
+        out += R"("name")";
+        out += colon;
+        out += R"("record)" + std::to_string(i) + '"';
+        out += ',';
+        newline(2);
+        out += R"("tags")";
+        out += colon;
+        out += '[';
+        newline(3);
+        out += R"("a",)";
+        newline(3);
+        out += R"("b")";
+        newline(2);
+        out += ']';
+        newline(1);
+        out += '}';
+        if (i + 1 < records) {
+            out += ',';
+        }
+    }
+    newline(0);
+    out += ']';
+    return out;
+}
+
+template <typename Fn>
+auto throughput(std::string_view input, Fn fn) -> double {
+    constexpr int rounds = 20;
+    auto          start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        fn(input);
+    }
+    std::chrono::duration<double> elapsed
+        = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(input.size()) * rounds / elapsed.count() / 1e6;
+}
+
+// Walks the input jumping over every whitespace run with `skip`.
+template <typename Skip>
+auto scan(std::string_view input, Skip skip) -> std::size_t {
+    std::size_t count = 0;
+    const auto *first = input.data();
+    const auto *last = first + input.size();
+    while (first != last) {
+        first = skip(first, last);
+        if (first != last) {
+            ++first;
+            ++count;
+        }
+    }
+    return count;
+}
+
+auto main() -> int {
+    constexpr std::size_t records = 20000;
+
+    for (std::size_t indent : {0, 2, 8}) {
+        auto input = make_document(records, indent);
+
+        auto parse = throughput(input, [](std::string_view in) {
+            auto obj = Json::deserialize(in);
+        });
+        auto scalar = throughput(input, [](std::string_view in) {
+            return scan(in, simd::detail::skip_whitespace_scalar);
+        });
+        auto vectorized = throughput(input, [](std::string_view in) {
+            return scan(in, simd::skip_whitespace);
+        });
+
+        PRINT_FMT("indent {}: {:>7.1f} MB/s parse, whitespace skip {:>7.1f} "
+                  "MB/s scalar / {:>7.1f} MB/s simd\n",
+                  indent,
+                  parse,
+                  scalar,
+                  vectorized);
+    }
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace jsonlib {
+
+// Bump allocator over a list of large blocks. Individual deallocations are
+// no-ops; all memory is returned at once by `release()` or the destructor.
+class Arena {
+public:
+    static constexpr std::size_t default_block_size = 64 * 1024;
+    static constexpr std::size_t max_block_size = 4 * 1024 * 1024;
+
+    explicit Arena(std::size_t block_size = default_block_size)
+        : block_size_{block_size} {}
+
+    Arena(Arena &&other) noexcept
+        : head_{std::exchange(other.head_, nullptr)}
+        , cursor_{std::exchange(other.cursor_, nullptr)}
+        , end_{std::exchange(other.end_, nullptr)}
+        , block_size_{other.block_size_} {}
+
+    auto operator=(Arena &&other) noexcept -> Arena & {
+        if (this != std::addressof(other)) {
+            release();
+            head_ = std::exchange(other.head_, nullptr);
+            cursor_ = std::exchange(other.cursor_, nullptr);
+            end_ = std::exchange(other.end_, nullptr);
+            block_size_ = other.block_size_;
+        }
+        return *this;
+    }
+
+    Arena(const Arena &) = delete;
+    auto operator=(const Arena &) -> Arena & = delete;
+
+    ~Arena() {
+        release();
+    }
+
+    auto allocate(std::size_t size, std::size_t alignment) -> void * {
+        void *ptr = bump(size, alignment);
+        if (ptr == nullptr) [[unlikely]] {
+            grow(size + alignment);
+            ptr = bump(size, alignment);
+        }
+        return ptr;
+    }
+
+    auto release() noexcept -> void {
+        while (head_ != nullptr) {
+            auto *next = head_->next_;
+            ::operator delete(head_);
+            head_ = next;
+        }
+        cursor_ = nullptr;
+        end_ = nullptr;
+    }
+
+private:
+    struct Block {
+        Block *next_;
+    };
+
+    auto bump(std::size_t size, std::size_t alignment) noexcept -> void * {
+        void *ptr = cursor_;
+        auto  space = static_cast<std::size_t>(end_ - cursor_);
+        if (ptr == nullptr
+            || std::align(alignment, size, ptr, space) == nullptr) {
+            return nullptr;
+        }
+        cursor_ = static_cast<char *>(ptr) + size;
+        return ptr;
+    }
+
+    // Blocks double in size (up to `max_block_size`) so that a large document
+    // ends up in a handful of them.
+    auto grow(std::size_t min_size) -> void {
+        auto size = std::max(block_size_, min_size + sizeof(Block));
+        auto *block = static_cast<Block *>(::operator new(size));
+        block->next_ = head_;
+        head_ = block;
+        cursor_ = reinterpret_cast<char *>(block + 1);
+        end_ = reinterpret_cast<char *>(block) + size;
+        block_size_ = std::min(size * 2, max_block_size);
+    }
+
+    Block      *head_{nullptr};
+    char       *cursor_{nullptr};
+    char       *end_{nullptr};
+    std::size_t block_size_;
+};
+
+// Standard allocator handing out memory from an `Arena`.
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena &arena) noexcept
+        : arena_{std::addressof(arena)} {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept
+        : arena_{other.arena()} {}
+
+    auto allocate(std::size_t n) -> T * {
+        return static_cast<T *>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    auto deallocate([[maybe_unused]] T          *ptr,
+                    [[maybe_unused]] std::size_t n) noexcept -> void {}
+
+    auto arena() const noexcept -> Arena * {
+        return arena_;
+    }
+
+    template <typename U>
+    auto operator==(const ArenaAllocator<U> &other) const noexcept -> bool {
+        return arena_ == other.arena();
+    }
+
+private:
+    Arena *arena_;
+};
+
+} // namespace jsonlib
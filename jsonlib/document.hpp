@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "jsonlib/arena.hpp"
+#include "jsonlib/jsonlib.hpp"
+
+namespace jsonlib {
+
+// A parse tree whose nodes, strings and containers all live in one `Arena`.
+// Node destructors never run: the whole tree is dropped with the arena.
+class Document {
+public:
+    using json_t = BasicJson<ArenaAllocator<char>>;
+
+    explicit Document(std::size_t block_size = Arena::default_block_size)
+        : arena_{std::make_unique<Arena>(block_size)}
+        , root_{create_root()} {}
+
+    static auto parse(std::string_view in,
+                      std::size_t block_size = Arena::default_block_size)
+        -> Document {
+        Document doc{block_size};
+        *doc.root_ = json_t::deserialize(in, doc.get_allocator());
+        return doc;
+    }
+
+    auto root() noexcept -> json_t & {
+        return *root_;
+    }
+
+    auto root() const noexcept -> const json_t & {
+        return *root_;
+    }
+
+    auto operator[](std::string_view key) -> json_t & {
+        return (*root_)[key];
+    }
+
+    auto serialize() const -> std::string {
+        return root_->serialize();
+    }
+
+    auto get_allocator() const noexcept -> ArenaAllocator<char> {
+        return ArenaAllocator<char>{*arena_};
+    }
+
+private:
+    auto create_root() -> json_t * {
+        auto *ptr = arena_->allocate(sizeof(json_t), alignof(json_t));
+        return std::construct_at(static_cast<json_t *>(ptr), get_allocator());
+    }
+
+    // Heap-allocated: every allocator in the tree points at the arena, so it
+    // must not move along with the Document.
+    std::unique_ptr<Arena> arena_;
+    json_t                *root_;
+};
+
+} // namespace jsonlib
@@ -1,89 +1,202 @@
 #pragma once
 
 #include <array>
-#include <sstream>
+#include <cstdint>
+#include <cstring>
+#include <string>
 #include <string_view>
 
-inline const std::array<std::string_view, 256> json_encode
-    = {"\x00", "\x01", "\x02", "\x03", "\x04", "\x05", "\x06", "\x07", "\\b",
-       "\\t",  "\\n",  "\x0b", "\\f",  "\\r",  "\x0e", "\x0f", "\x10", "\x11",
-       "\x12", "\x13", "\x14", "\x15", "\x16", "\x17", "\x18", "\x19", "\x1a",
-       "\x1b", "\x1c", "\x1d", "\x1e", "\x1f", "\x20", "\x21", "\\\"", "\x23",
-       "\x24", "\x25", "\x26", "\x27", "\x28", "\x29", "\x2a", "\x2b", "\x2c",
-       "\x2d", "\x2e", "\\/",  "\x30", "\x31", "\x32", "\x33", "\x34", "\x35",
-       "\x36", "\x37", "\x38", "\x39", "\x3a", "\x3b", "\x3c", "\x3d", "\x3e",
-       "\x3f", "\x40", "\x41", "\x42", "\x43", "\x44", "\x45", "\x46", "\x47",
-       "\x48", "\x49", "\x4a", "\x4b", "\x4c", "\x4d", "\x4e", "\x4f", "\x50",
-       "\x51", "\x52", "\x53", "\x54", "\x55", "\x56", "\x57", "\x58", "\x59",
-       "\x5a", "\x5b", "\\\\", "\x5d", "\x5e", "\x5f", "\x60", "\x61", "\x62",
-       "\x63", "\x64", "\x65", "\x66", "\x67", "\x68", "\x69", "\x6a", "\x6b",
-       "\x6c", "\x6d", "\x6e", "\x6f", "\x70", "\x71", "\x72", "\x73", "\x74",
-       "\x75", "\x76", "\x77", "\x78", "\x79", "\x7a", "\x7b", "\x7c", "\x7d",
-       "\x7e", "\x7f", "\x80", "\x81", "\x82", "\x83", "\x84", "\x85", "\x86",
-       "\x87", "\x88", "\x89", "\x8a", "\x8b", "\x8c", "\x8d", "\x8e", "\x8f",
-       "\x90", "\x91", "\x92", "\x93", "\x94", "\x95", "\x96", "\x97", "\x98",
-       "\x99", "\x9a", "\x9b", "\x9c", "\x9d", "\x9e", "\x9f", "\xa0", "\xa1",
-       "\xa2", "\xa3", "\xa4", "\xa5", "\xa6", "\xa7", "\xa8", "\xa9", "\xaa",
-       "\xab", "\xac", "\xad", "\xae", "\xaf", "\xb0", "\xb1", "\xb2", "\xb3",
-       "\xb4", "\xb5", "\xb6", "\xb7", "\xb8", "\xb9", "\xba", "\xbb", "\xbc",
-       "\xbd", "\xbe", "\xbf", "\xc0", "\xc1", "\xc2", "\xc3", "\xc4", "\xc5",
-       "\xc6", "\xc7", "\xc8", "\xc9", "\xca", "\xcb", "\xcc", "\xcd", "\xce",
-       "\xcf", "\xd0", "\xd1", "\xd2", "\xd3", "\xd4", "\xd5", "\xd6", "\xd7",
-       "\xd8", "\xd9", "\xda", "\xdb", "\xdc", "\xdd", "\xde", "\xdf", "\xe0",
-       "\xe1", "\xe2", "\xe3", "\xe4", "\xe5", "\xe6", "\xe7", "\xe8", "\xe9",
-       "\xea", "\xeb", "\xec", "\xed", "\xee", "\xef", "\xf0", "\xf1", "\xf2",
-       "\xf3", "\xf4", "\xf5", "\xf6", "\xf7", "\xf8", "\xf9", "\xfa", "\xfb",
-       "\xfc", "\xfd", "\xfe", "\xff"};
+// Output for every byte inside a JSON string. Only '"', '\\' and control
+// characters need escaping; all other entries map a byte to itself.
+inline constexpr std::array<std::string_view, 256> json_encode
+    = {"\\u0000", "\\u0001", "\\u0002", "\\u0003", "\\u0004", "\\u0005",
+       "\\u0006", "\\u0007", "\\b",     "\\t",     "\\n",     "\\u000b",
+       "\\f",     "\\r",     "\\u000e", "\\u000f", "\\u0010", "\\u0011",
+       "\\u0012", "\\u0013", "\\u0014", "\\u0015", "\\u0016", "\\u0017",
+       "\\u0018", "\\u0019", "\\u001a", "\\u001b", "\\u001c", "\\u001d",
+       "\\u001e", "\\u001f", "\x20",    "\x21",    "\\\"",    "\x23",
+       "\x24",    "\x25",    "\x26",    "\x27",    "\x28",    "\x29",
+       "\x2a",    "\x2b",    "\x2c",    "\x2d",    "\x2e",    "\x2f",
+       "\x30",    "\x31",    "\x32",    "\x33",    "\x34",    "\x35",
+       "\x36",    "\x37",    "\x38",    "\x39",    "\x3a",    "\x3b",
+       "\x3c",    "\x3d",    "\x3e",    "\x3f",    "\x40",    "\x41",
+       "\x42",    "\x43",    "\x44",    "\x45",    "\x46",    "\x47",
+       "\x48",    "\x49",    "\x4a",    "\x4b",    "\x4c",    "\x4d",
+       "\x4e",    "\x4f",    "\x50",    "\x51",    "\x52",    "\x53",
+       "\x54",    "\x55",    "\x56",    "\x57",    "\x58",    "\x59",
+       "\x5a",    "\x5b",    "\\\\",    "\x5d",    "\x5e",    "\x5f",
+       "\x60",    "\x61",    "\x62",    "\x63",    "\x64",    "\x65",
+       "\x66",    "\x67",    "\x68",    "\x69",    "\x6a",    "\x6b",
+       "\x6c",    "\x6d",    "\x6e",    "\x6f",    "\x70",    "\x71",
+       "\x72",    "\x73",    "\x74",    "\x75",    "\x76",    "\x77",
+       "\x78",    "\x79",    "\x7a",    "\x7b",    "\x7c",    "\x7d",
+       "\x7e",    "\x7f",    "\x80",    "\x81",    "\x82",    "\x83",
+       "\x84",    "\x85",    "\x86",    "\x87",    "\x88",    "\x89",
+       "\x8a",    "\x8b",    "\x8c",    "\x8d",    "\x8e",    "\x8f",
+       "\x90",    "\x91",    "\x92",    "\x93",    "\x94",    "\x95",
+       "\x96",    "\x97",    "\x98",    "\x99",    "\x9a",    "\x9b",
+       "\x9c",    "\x9d",    "\x9e",    "\x9f",    "\xa0",    "\xa1",
+       "\xa2",    "\xa3",    "\xa4",    "\xa5",    "\xa6",    "\xa7",
+       "\xa8",    "\xa9",    "\xaa",    "\xab",    "\xac",    "\xad",
+       "\xae",    "\xaf",    "\xb0",    "\xb1",    "\xb2",    "\xb3",
+       "\xb4",    "\xb5",    "\xb6",    "\xb7",    "\xb8",    "\xb9",
+       "\xba",    "\xbb",    "\xbc",    "\xbd",    "\xbe",    "\xbf",
+       "\xc0",    "\xc1",    "\xc2",    "\xc3",    "\xc4",    "\xc5",
+       "\xc6",    "\xc7",    "\xc8",    "\xc9",    "\xca",    "\xcb",
+       "\xcc",    "\xcd",    "\xce",    "\xcf",    "\xd0",    "\xd1",
+       "\xd2",    "\xd3",    "\xd4",    "\xd5",    "\xd6",    "\xd7",
+       "\xd8",    "\xd9",    "\xda",    "\xdb",    "\xdc",    "\xdd",
+       "\xde",    "\xdf",    "\xe0",    "\xe1",    "\xe2",    "\xe3",
+       "\xe4",    "\xe5",    "\xe6",    "\xe7",    "\xe8",    "\xe9",
+       "\xea",    "\xeb",    "\xec",    "\xed",    "\xee",    "\xef",
+       "\xf0",    "\xf1",    "\xf2",    "\xf3",    "\xf4",    "\xf5",
+       "\xf6",    "\xf7",    "\xf8",    "\xf9",    "\xfa",    "\xfb",
+       "\xfc",    "\xfd",    "\xfe",    "\xff"};
 
-inline auto json_decode(std::string_view input) -> std::string {
-    std::ostringstream out;
+// Character denoted by the two-character escape `\c`, or '\0' if `c` does not
+// form one.
+constexpr auto json_unescape(char c) noexcept -> char {
+    switch (c) {
+    case '"':
+        return '"';
+    case '\\':
+        return '\\';
+    case '/':
+        return '/';
+    case 'b':
+        return '\b';
+    case 'f':
+        return '\f';
+    case 'n':
+        return '\n';
+    case 'r':
+        return '\r';
+    case 't':
+        return '\t';
+    default:
+        return '\0';
+    }
+}
 
-    std::size_t pos = 0;
-    while (pos < input.length()) {
-        if (input[pos] == '\\') {
-            ++pos;
-            switch (input[pos]) {
-            // Simple translations.
-            case '"':
-                out << '"';
-                break;
-            case '\\':
-                out << '\\';
-                break;
-            case '/':
-                out << '/';
-                break;
-            case 'b':
-                out << '\b';
-                break;
-            case 'f':
-                out << '\f';
-                break;
-            case 'n':
-                out << '\n';
-                break;
-            case 'r':
-                out << '\r';
-                break;
-            case 't':
-                out << '\t';
-                break;
+namespace jsonlib::detail {
+constexpr auto parse_hex4(const char *first, const char *last) noexcept
+    -> std::int32_t {
+    if (last - first < 4) {
+        return -1;
+    }
+    std::int32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        auto c = first[i];
+        value <<= 4;
+        if ('0' <= c && c <= '9') {
+            value |= c - '0';
+        } else if ('a' <= (c | 0x20) && (c | 0x20) <= 'f') {
+            value |= (c | 0x20) - 'a' + 10;
+        } else {
+            return -1;
+        }
+    }
+    return value;
+}
+
+constexpr auto encode_utf8(char32_t code_point, char *out) noexcept
+    -> char * {
+    if (code_point < 0x80) {
+        *out++ = static_cast<char>(code_point);
+    } else if (code_point < 0x800) {
+        *out++ = static_cast<char>(0xc0 | (code_point >> 6));
+        *out++ = static_cast<char>(0x80 | (code_point & 0x3f));
+    } else if (code_point < 0x10000) {
+        *out++ = static_cast<char>(0xe0 | (code_point >> 12));
+        *out++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+        *out++ = static_cast<char>(0x80 | (code_point & 0x3f));
+    } else {
+        *out++ = static_cast<char>(0xf0 | (code_point >> 18));
+        *out++ = static_cast<char>(0x80 | ((code_point >> 12) & 0x3f));
+        *out++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+        *out++ = static_cast<char>(0x80 | (code_point & 0x3f));
+    }
+    return out;
+}
+} // namespace jsonlib::detail
 
-            // If it is an unrecognized sequence, do nothing.
-            default:
-                out << '\\';
-                out << input[pos];
-                break;
-            }
-            ++pos;
+// Decodes the escape sequence at `first` (which points at a backslash) into
+// `out` and returns the position after it. \uXXXX escapes become UTF-8, with
+// surrogate pairs combined and lone surrogates replaced by U+FFFD.
+// Unrecognized sequences are copied as they are. The output is never longer
+// than the consumed input, so `out` may trail `first` in the same buffer.
+constexpr auto json_unescape_to(const char *first,
+                                const char *last,
+                                char      *&out) -> const char * {
+    if (last - first < 2) {
+        *out++ = *first;
+        return first + 1;
+    }
+    if (first[1] != 'u') {
+        if (auto c = json_unescape(first[1]); c != '\0') {
+            *out++ = c;
         } else {
-            size_t next_backslash = input.find('\\', pos);
-            if (next_backslash == std::string_view::npos) {
-                next_backslash = input.length();
-            }
-            out << std::string_view{input.data() + pos, next_backslash - pos};
-            pos = next_backslash;
+            *out++ = first[0];
+            *out++ = first[1];
+        }
+        return first + 2;
+    }
+
+    auto unit = jsonlib::detail::parse_hex4(first + 2, last);
+    if (unit < 0) {
+        *out++ = first[0];
+        *out++ = first[1];
+        return first + 2;
+    }
+    first += 6;
+    auto code_point = static_cast<char32_t>(unit);
+    if (0xd800 <= unit && unit <= 0xdfff) {
+        code_point = 0xfffd;
+        std::int32_t low = -1;
+        if (unit <= 0xdbff && last - first >= 6 && first[0] == '\\'
+            && first[1] == 'u') {
+            low = jsonlib::detail::parse_hex4(first + 2, last);
+        }
+        if (0xdc00 <= low && low <= 0xdfff) {
+            code_point = 0x10000
+                         + ((static_cast<char32_t>(unit) - 0xd800) << 10)
+                         + (static_cast<char32_t>(low) - 0xdc00);
+            first += 6;
         }
     }
-    return out.str();
+    out = jsonlib::detail::encode_utf8(code_point, out);
+    return first;
+}
+
+// Decodes the body of a JSON string (without quotes) into `out`, which must
+// have room for `input.size()` characters, and returns the end of the
+// output. Decoding in place (`out == input.data()`) is allowed. memchr jumps
+// from one backslash to the next.
+inline auto json_decode(std::string_view input, char *out) -> char * {
+    const auto *first = input.data();
+    const auto *last = first + input.size();
+    while (first != last) {
+        const auto *backslash = static_cast<const char *>(
+            std::memchr(first, '\\', static_cast<std::size_t>(last - first)));
+        if (backslash == nullptr) {
+            backslash = last;
+        }
+        auto run = static_cast<std::size_t>(backslash - first);
+        if (out != first) {
+            std::memmove(out, first, run);
+        }
+        out += run;
+        if (backslash == last) {
+            break;
+        }
+        first = json_unescape_to(backslash, last, out);
+    }
+    return out;
+}
+
+inline auto json_decode(std::string_view input) -> std::string {
+    std::string out(input.size(), '\0');
+    out.resize(static_cast<std::size_t>(json_decode(input, out.data())
+                                        - out.data()));
+    return out;
 }
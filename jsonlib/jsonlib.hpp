@@ -1,70 +1,207 @@
 #pragma once
 
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
 #include <initializer_list>
-#include <map>
+#include <limits>
 #include <memory>
-#include <sstream>
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "jsonlib/debug.hpp"
 #include "jsonlib/json_codec.hpp"
+#include "jsonlib/ordered_map.hpp"
+#include "jsonlib/parse_error.hpp"
+#include "jsonlib/simd.hpp"
+#include "jsonlib/structural_index.hpp"
+#include "jsonlib/tokenizer.hpp"
+#include "jsonlib/validate.hpp"
+#include "jsonlib/writer.hpp"
 
 namespace jsonlib {
 
-class Json {
-    using array_t = std::vector<Json>;
-    using object_t = std::map<std::string, Json>;
-    struct Data {
-        std::shared_ptr<object_t> object_;
-        std::shared_ptr<array_t>  array_;
-        double                    number_{};
-        std::string               string_;
-    };
-    enum class Type {
+namespace detail {
+    enum class Type : std::uint8_t {
         Object,
         Array,
         String,
-        Number,
+        StringView,
+        Int64,
+        UInt64,
+        Double,
         True,
         False,
         Null,
     };
+} // namespace detail
+
+struct ParseOptions {
+    // String values without escape sequences reference the input instead of
+    // being copied; the input must then outlive the parsed tree.
+    bool borrow_strings = false;
+    // Deeper nesting is rejected, so hostile input cannot exhaust the stack.
+    std::size_t max_depth = 1024;
+};
+
+template <typename Allocator>
+class BasicStreamParser;
+
+// Every string, container and child node of a BasicJson is allocated through
+// (a rebound copy of) `Allocator`. `Json` below uses the default allocator.
+template <typename Allocator = std::allocator<char>>
+class BasicJson {
+    template <typename T>
+    using allocator_for =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+    using string_t
+        = std::basic_string<char, std::char_traits<char>, allocator_for<char>>;
+    using array_t = std::vector<BasicJson, allocator_for<BasicJson>>;
+    using object_t = OrderedMap<string_t, BasicJson, Allocator>;
+    using Type = detail::Type;
 
     using enum Type;
 
+    // Only the member selected by `Type` is active. Strings and containers
+    // live behind a pointer so that a scalar node stays 16 bytes; a
+    // StringView keeps its length in `Value::size_`.
+    union Data {
+        std::int64_t  int64_;
+        std::uint64_t uint64_;
+        double        double_;
+        string_t     *string_;
+        const char   *view_;
+        array_t      *array_;
+        object_t     *object_;
+    };
+
     struct Value {
-        Type type_;
-        Data data_;
+        Type                            type_;
+        std::uint32_t                   size_{};
+        Data                            data_{};
+        [[no_unique_address]] Allocator alloc_;
 
         Value()
-            : type_{Null} {}
+            : Value(Allocator()) {}
+
+        explicit Value(const Allocator &alloc)
+            : type_{Null}
+            , alloc_{alloc} {}
 
-        Value(bool value)
-            : type_{value ? True : False} {}
+        Value(bool value, const Allocator &alloc = Allocator())
+            : type_{value ? True : False}
+            , alloc_{alloc} {}
+
+        template <typename T>
+            requires(std::is_integral_v<T> && std::is_signed_v<T>)
+        Value(T value, const Allocator &alloc = Allocator())
+            : type_{Int64}
+            , alloc_{alloc} {
+            data_.int64_ = value;
+        }
+
+        template <typename T>
+            requires(std::is_integral_v<T> && std::is_unsigned_v<T>)
+        Value(T value, const Allocator &alloc = Allocator())
+            : type_{UInt64}
+            , alloc_{alloc} {
+            data_.uint64_ = value;
+        }
 
         template <typename T>
-            requires(std::is_floating_point_v<T> || std::is_integral_v<T>)
-        Value(T value)
-            : type_{Number} {
-            data_.number_ = value;
+            requires(std::is_floating_point_v<T>)
+        Value(T value, const Allocator &alloc = Allocator())
+            : type_{Double}
+            , alloc_{alloc} {
+            data_.double_ = static_cast<double>(value);
         }
 
         template <typename T>
             requires(std::is_convertible_v<T, std::string_view>)
-        Value(T value)
-            : type_{String} {
-            data_.string_ = value;
+        Value(T value, const Allocator &alloc = Allocator())
+            : type_{String}
+            , alloc_{alloc} {
+            data_.string_ = create<string_t>(std::string_view{value}, alloc_);
         }
 
-        Value(std::initializer_list<Json> values)
-            : type_{Array} {
-            data_.array_ = std::make_shared<array_t>(values);
+        Value(std::initializer_list<BasicJson> values,
+              const Allocator                 &alloc = Allocator())
+            : type_{Array}
+            , alloc_{alloc} {
+            data_.array_ = create<array_t>(values, alloc_);
+        }
+
+        Value(const Value &other)
+            : Value(other,
+                    std::allocator_traits<
+                        Allocator>::select_on_container_copy_construction(
+                        other.alloc_)) {}
+
+        Value(const Value &other, const Allocator &alloc)
+            : type_{other.type_}
+            , size_{other.size_}
+            , alloc_{alloc} {
+            switch (type_) {
+            case String:
+                data_.string_ = create<string_t>(*other.data_.string_, alloc_);
+                break;
+            case Array:
+                data_.array_ = create<array_t>(*other.data_.array_, alloc_);
+                break;
+            case Object:
+                data_.object_ = create<object_t>(*other.data_.object_, alloc_);
+                break;
+            default:
+                data_ = other.data_;
+                break;
+            }
+        }
+
+        Value(Value &&other) noexcept
+            : type_{other.type_}
+            , size_{other.size_}
+            , data_{other.data_}
+            , alloc_{other.alloc_} {
+            other.type_ = Null;
+        }
+
+        // Assignment keeps this node's allocator: a payload coming from a
+        // different allocator is copied rather than adopted.
+        auto operator=(const Value &other) -> Value & {
+            if (this != std::addressof(other)) {
+                adopt(Value{other, alloc_});
+            }
+            return *this;
+        }
+
+        auto operator=(Value &&other) -> Value & {
+            if (this != std::addressof(other)) {
+                if (alloc_ == other.alloc_) {
+                    adopt(std::move(other));
+                } else {
+                    adopt(Value{other, alloc_});
+                }
+            }
+            return *this;
+        }
+
+        ~Value() {
+            release();
         }
 
         auto operator==(const Value &another) const noexcept -> bool {
+            if (this->is_string() && another.is_string()) {
+                return this->view() == another.view();
+            }
+            if (this->is_number() && another.is_number()) {
+                return equal_numbers(*this, another);
+            }
             if (this->type_ != another.type_) {
                 return false;
             }
@@ -75,52 +212,103 @@ class Json {
             case False:
                 return true;
             case String:
-                return this->data_.string_ == another.data_.string_;
-            case Number:
-                return this->data_.number_ == another.data_.number_; // ?
+            case StringView:
+                return this->view() == another.view();
+            case Int64:
+            case UInt64:
+            case Double:
+                return equal_numbers(*this, another);
             case Array:
                 return *this->data_.array_ == *another.data_.array_;
             case Object:
                 return *this->data_.object_ == *another.data_.object_;
             }
+            return false;
         }
 
         template <Type T>
-        auto is() -> bool {
+        auto is() const noexcept -> bool {
             return type_ == T;
         }
 
+        auto is_string() const noexcept -> bool {
+            return type_ == String || type_ == StringView;
+        }
+
+        auto is_number() const noexcept -> bool {
+            return type_ == Int64 || type_ == UInt64 || type_ == Double;
+        }
+
+        // Any number kind converted to `T`; integers outside the range of
+        // `T` wrap as with static_cast.
+        template <typename T>
+        auto number_as() const noexcept -> T {
+            switch (type_) {
+            case Int64:
+                return static_cast<T>(data_.int64_);
+            case UInt64:
+                return static_cast<T>(data_.uint64_);
+            case Double:
+                return static_cast<T>(data_.double_);
+            default:
+                ASSERT_MSG(false, "not a number");
+                return T{};
+            }
+        }
+
+        // The characters of a String or StringView.
+        auto view() const noexcept -> std::string_view {
+            if (type_ == StringView) {
+                return {data_.view_, size_};
+            }
+            return *data_.string_;
+        }
+
+        auto borrow(std::string_view str) noexcept -> void {
+            release();
+            type_ = StringView;
+            size_ = static_cast<std::uint32_t>(str.length());
+            data_.view_ = str.data();
+        }
+
         template <Type T>
         auto to() -> void {
+            release();
             type_ = T;
+            if constexpr (T == String) {
+                data_.string_ = create<string_t>(alloc_);
+            } else if constexpr (T == Array) {
+                data_.array_ = create<array_t>(alloc_);
+            } else if constexpr (T == Object) {
+                data_.object_ = create<object_t>(alloc_);
+            }
         }
 
         template <Type T>
-        auto as() {
+        auto as() const -> decltype(auto) {
             if constexpr (T == Null) {
                 return nullptr;
             } else if constexpr (T == False) {
                 return false;
             } else if constexpr (T == True) {
                 return true;
-            } else if constexpr (T == Number) {
-                return data_.number_;
+            } else if constexpr (T == Int64) {
+                return (data_.int64_);
+            } else if constexpr (T == UInt64) {
+                return (data_.uint64_);
+            } else if constexpr (T == Double) {
+                return (data_.double_);
             } else if constexpr (T == String) {
-                return data_.string_;
+                return (*data_.string_);
             } else if constexpr (T == Array) {
-                if (!data_.array_) {
-                    data_.array_ = std::make_shared<array_t>();
-                }
-                return data_.array_;
+                return (*data_.array_);
             } else if constexpr (T == Object) {
-                if (!data_.object_) {
-                    data_.object_ = std::make_shared<object_t>();
-                }
-                return data_.object_;
+                return (*data_.object_);
             }
         }
 
-        auto serialize_to(std::ostringstream &out) const -> void {
+        template <Writer W>
+        auto serialize_to(W &out) const -> void {
             switch (type_) {
             case Object:
                 serialize_object(out);
@@ -129,36 +317,86 @@ class Json {
                 serialize_array(out);
                 break;
             case String:
+            case StringView:
                 serialize_string(out);
                 break;
-            case Number:
-                out << data_.number_;
+            case Int64:
+            case UInt64:
+            case Double:
+                serialize_number(out);
                 break;
             case True:
-                out << "true";
+                out.write("true");
                 break;
             case False:
-                out << "false";
+                out.write("false");
                 break;
             case Null:
-                out << "null";
+                out.write("null");
                 break;
             default:
-                out << "?";
+                out.put('?');
+            }
+        }
+
+        struct ParseContext {
+            Allocator    alloc_;
+            ParseOptions options_;
+            // Receives the first error; without it, malformed input fails an
+            // assertion.
+            ParseError *error_{nullptr};
+            // containers currently open
+            mutable std::size_t depth_{0};
+        };
+
+        // Malformed input at `pos`: records the error and moves `pos` to the
+        // end of the input, so every enclosing loop stops at once and the
+        // partial tree is discarded. Kept out of line so that the checks on
+        // the hot path are a single predictable branch.
+        [[gnu::cold]] [[gnu::noinline]] static auto
+        fail(std::string_view    in,
+             std::size_t        &pos,
+             const ParseContext &ctx,
+             ParseError::Kind    kind) -> BasicJson {
+            if (ctx.error_ == nullptr) {
+                ASSERT_MSG(false, "malformed JSON");
+            } else if (ctx.error_->kind == ParseError::Kind::None) {
+                ctx.error_->kind = kind;
+                ctx.error_->offset = pos;
             }
+            pos = in.length();
+            return BasicJson{ctx.alloc_};
+        }
+
+        // The same for the indexed parser, at the structural character
+        // `next` points to.
+        [[gnu::cold]] [[gnu::noinline]] static auto
+        fail(std::string_view      in,
+             const std::uint32_t *&next,
+             const std::uint32_t  *end,
+             const ParseContext   &ctx,
+             ParseError::Kind      kind) -> BasicJson {
+            std::size_t pos = next != end ? *next : in.length();
+            next = end;
+            return fail(in, pos, ctx, kind);
         }
 
         // static auto deserialize_from(std::istringstream &in) -> Json {
-        static auto deserialize_from(std::string_view in, std::size_t &pos)
-            -> Json {
-            eat_whitespace(in, pos);
+        static auto deserialize_from(std::string_view    in,
+                                     std::size_t        &pos,
+                                     const ParseContext &ctx)
+            -> BasicJson {
+            detail::eat_whitespace(in, pos);
+            if (pos == in.length()) {
+                return BasicJson{ctx.alloc_};
+            }
             switch (in[pos]) {
             case 'n':
-                return deserialize_null(in, pos);
+                return deserialize_null(in, pos, ctx);
             case 't':
-                return deserialize_true(in, pos);
+                return deserialize_true(in, pos, ctx);
             case 'f':
-                return deserialize_false(in, pos);
+                return deserialize_false(in, pos, ctx);
             case '-':
             case '0':
             case '1':
@@ -170,293 +408,767 @@ class Json {
             case '7':
             case '8':
             case '9':
-                return deserialize_number(in, pos);
+                return deserialize_number(in, pos, ctx);
             case '"':
-                return deserialize_string(in, pos);
+                return deserialize_string(in, pos, ctx);
             case '[':
-                return deserialize_array(in, pos);
+                return deserialize_array(in, pos, ctx);
             case '{':
-                return deserialize_object(in, pos);
+                return deserialize_object(in, pos, ctx);
             default:
                 break;
             }
-            return {};
+            return fail(in, pos, ctx, ParseError::Kind::UnexpectedCharacter);
         }
 
-    private:
-        static auto eat_whitespace(std::string_view in, std::size_t &pos)
-            -> void {
-            auto length = in.length();
-            while (pos < length) {
-                switch (in[pos]) {
-                case ' ':
-                case '\r':
-                case '\n':
-                    pos++;
-                    break;
-                default:
-                    return;
+        // Stage 2 of two-stage parsing: `next` walks a StructuralIndex of
+        // `in`, so containers step from one structural character to the
+        // next without scanning whitespace or skipping over strings.
+        // Scalars are converted by the regular parser from their start.
+        static auto deserialize_indexed(std::string_view      in,
+                                        const std::uint32_t *&next,
+                                        const std::uint32_t  *end,
+                                        const ParseContext   &ctx)
+            -> BasicJson {
+            using enum ParseError::Kind;
+            if (next == end) [[unlikely]] {
+                return fail(in, next, end, ctx, UnexpectedEnd);
+            }
+            if ((in[*next] == '[' || in[*next] == '{')
+                && ctx.depth_ == ctx.options_.max_depth) [[unlikely]] {
+                return fail(in, next, end, ctx, TooDeep);
+            }
+            std::size_t pos = *next++;
+            switch (in[pos]) {
+            case '[': {
+                ctx.depth_++;
+                BasicJson ret{ctx.alloc_};
+                ret.value_.template to<Array>();
+                auto &array = ret.value_.template as<Array>();
+                if (next != end && in[*next] == ']') {
+                    next++;
+                    ctx.depth_--;
+                    return ret;
                 }
+                while (true) {
+                    array.push_back(deserialize_indexed(in, next, end, ctx));
+                    if (next == end) [[unlikely]] {
+                        return fail(in, next, end, ctx, UnexpectedEnd);
+                    }
+                    if (in[*next] == ']') {
+                        next++;
+                        ctx.depth_--;
+                        return ret;
+                    }
+                    if (in[*next] != ',') [[unlikely]] {
+                        return fail(in, next, end, ctx, ExpectedCommaOrBracket);
+                    }
+                    next++;
+                }
+            }
+            case '{': {
+                ctx.depth_++;
+                BasicJson ret{ctx.alloc_};
+                ret.value_.template to<Object>();
+                auto &object = ret.value_.template as<Object>();
+                if (next != end && in[*next] == '}') {
+                    next++;
+                    ctx.depth_--;
+                    return ret;
+                }
+                while (true) {
+                    if (next == end || in[*next] != '"') [[unlikely]] {
+                        return fail(in, next, end, ctx, ExpectedKey);
+                    }
+                    string_t key{ctx.alloc_};
+                    if (detail::decode_string(in, *next + 1, key)
+                        == std::string_view::npos) [[unlikely]] {
+                        return fail(in, next, end, ctx, UnterminatedString);
+                    }
+                    next++;
+                    if (next == end || in[*next] != ':') [[unlikely]] {
+                        return fail(in, next, end, ctx, ExpectedColon);
+                    }
+                    next++;
+                    auto value = deserialize_indexed(in, next, end, ctx);
+                    object.insert_or_assign(std::move(key), std::move(value));
+                    if (next == end) [[unlikely]] {
+                        return fail(in, next, end, ctx, UnexpectedEnd);
+                    }
+                    if (in[*next] == '}') {
+                        next++;
+                        ctx.depth_--;
+                        return ret;
+                    }
+                    if (in[*next] != ',') [[unlikely]] {
+                        return fail(in, next, end, ctx, ExpectedCommaOrBrace);
+                    }
+                    next++;
+                }
+            }
+            default: {
+                auto value = deserialize_from(in, pos, ctx);
+                if (!ends_scalar(in, pos)) [[unlikely]] {
+                    return fail(in, pos, ctx, UnexpectedCharacter);
+                }
+                return value;
+            }
+            }
+        }
+
+    private:
+        // Whether a scalar converted from the index may end before `pos`: at
+        // the end of the input, whitespace or a structural character. Any
+        // other character continues the same token ("1.5.5", "truex"), so
+        // the index has no position for it and only this check catches it.
+        static auto ends_scalar(std::string_view in, std::size_t pos) noexcept
+            -> bool {
+            if (pos == in.length()) {
+                return true;
+            }
+            switch (in[pos]) {
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+            case '"':
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        // The payload objects get the allocator passed explicitly, so they
+        // are constructed in place rather than through allocator_traits.
+        template <typename T, typename... Args>
+        auto create(Args &&...args) -> T * {
+            using traits = std::allocator_traits<allocator_for<T>>;
+            allocator_for<T> alloc{alloc_};
+            return std::construct_at(traits::allocate(alloc, 1),
+                                     std::forward<Args>(args)...);
+        }
+
+        template <typename T>
+        auto destroy(T *ptr) noexcept -> void {
+            using traits = std::allocator_traits<allocator_for<T>>;
+            allocator_for<T> alloc{alloc_};
+            std::destroy_at(ptr);
+            traits::deallocate(alloc, ptr, 1);
+        }
+
+        auto adopt(Value &&other) noexcept -> void {
+            release();
+            type_ = std::exchange(other.type_, Null);
+            size_ = other.size_;
+            data_ = other.data_;
+        }
+
+        auto release() noexcept -> void {
+            switch (type_) {
+            case String:
+                destroy(data_.string_);
+                break;
+            case Array:
+                destroy(data_.array_);
+                break;
+            case Object:
+                destroy(data_.object_);
+                break;
+            default:
+                break;
+            }
+            type_ = Null;
+        }
+
+        // Integers compare exactly; as soon as a double is involved both
+        // sides are compared as doubles.
+        static auto equal_numbers(const Value &lhs, const Value &rhs) noexcept
+            -> bool {
+            if (lhs.type_ == Double || rhs.type_ == Double) {
+                return lhs.template number_as<double>()
+                       == rhs.template number_as<double>();
+            }
+            if (lhs.type_ == rhs.type_) {
+                return lhs.data_.uint64_ == rhs.data_.uint64_;
             }
+            // One Int64 and one UInt64: equal only when both are in range.
+            const auto &signed_side = lhs.type_ == Int64 ? lhs : rhs;
+            const auto &unsigned_side = lhs.type_ == Int64 ? rhs : lhs;
+            return signed_side.data_.int64_ >= 0
+                   && signed_side.data_.uint64_ == unsigned_side.data_.uint64_;
         }
-        auto serialize_object(std::ostringstream &out) const noexcept -> void {
+
+        template <Writer W>
+        auto serialize_object(W &out) const -> void {
             auto        n = data_.object_->size();
             std::size_t i{0};
 
-            out << '{';
+            out.put('{');
             for (auto &it : *data_.object_) {
-                out << '"' << it.first << '"';
-                out << ": ";
-                it.second.value_->serialize_to(out);
+                detail::write_escaped(out, it.first);
+                out.write(": ");
+                it.second.value_.serialize_to(out);
                 if (++i < n) {
-                    out << ", ";
+                    out.write(", ");
                 }
             }
-            out << '}';
+            out.put('}');
         }
 
-        auto serialize_array(std::ostringstream &out) const noexcept -> void {
+        template <Writer W>
+        auto serialize_array(W &out) const -> void {
             auto        n = data_.array_->size();
             std::size_t i{0};
 
-            out << '[';
+            out.put('[');
             for (auto &it : *data_.array_) {
-                it.value_->serialize_to(out);
+                it.value_.serialize_to(out);
                 if (++i < n) {
-                    out << ", ";
+                    out.write(", ");
                 }
             }
-            out << ']';
-        }
-
-        auto serialize_string(std::ostringstream &out) const noexcept -> void {
-            out << '"';
-            auto &input = data_.string_;
-            auto  first = input.begin();
-            for (auto last = input.begin(); last != input.end(); ++last) {
-                switch (*last) {
-                // Simple translations.
-                case '"':
-                case '\\':
-                case '/':
-                case '\b':
-                case '\f':
-                case '\n':
-                case '\r':
-                case '\t':
-                    out << std::string_view{first, last};
-                    out << json_encode.at(static_cast<unsigned char>(*last));
-                    first = last + 1;
-
-                default:;
-                    // Default NOP.
-                }
+            out.put(']');
+        }
+
+        template <Writer W>
+        auto serialize_number(W &out) const -> void {
+            switch (type_) {
+            case Int64:
+                detail::write_number(out, data_.int64_);
+                break;
+            case UInt64:
+                detail::write_number(out, data_.uint64_);
+                break;
+            default:
+                detail::write_number(out, data_.double_);
+                break;
             }
-            out << std::string_view{first, input.end()};
-            out << '"';
-
-            // case '\\':
-            //     out << "\\\\";
-            //     break;
-            // case '"':
-            //     out << "\\\"";
-            //     break;
-            // case '/':
-            //     out << "\\/";
-            //     break;
-            // case '\b':
-            //     out << "\\b";
-            //     break;
-            // case '\f':
-            //     out << "\\f";
-            //     break;
-            // case '\n':
-            //     out << "\\n";
-            //     break;
-            // case '\r':
-            //     out << "\\r";
-            //     break;
-            // case '\t':
-            //     out << "\\t";
-            //     break;
-            // default:
-            //     out << *last;
-            //     break;
-        }
-
-        static auto deserialize_null(std::string_view in, std::size_t &pos)
-            -> Json {
-            ASSERT(in.substr(pos, 4) == "null");
-            pos += 4;
-            return {};
-        }
-        static auto deserialize_false(std::string_view in, std::size_t &pos)
-            -> Json {
-            ASSERT(in.substr(pos, 5) == "false");
-            pos += 5;
-            return false;
         }
-        static auto deserialize_true(std::string_view in, std::size_t &pos)
-            -> Json {
-            ASSERT(in.substr(pos, 4) == "true");
-            pos += 4;
-            return true;
+
+        template <Writer W>
+        auto serialize_string(W &out) const -> void {
+            detail::write_escaped(out, view());
         }
-        static auto deserialize_string(std::string_view in, std::size_t &pos)
-            -> Json {
-            auto start = pos;
-            auto length = in.length();
-            ASSERT(in[pos] == '"');
-            pos++;
-            while (pos < length && in[pos] != '"') {
-                pos++;
+
+        static auto deserialize_null(std::string_view    in,
+                                     std::size_t        &pos,
+                                     const ParseContext &ctx)
+            -> BasicJson {
+            if (!detail::expect_literal(in, pos, "null")) [[unlikely]] {
+                return fail(in, pos, ctx, ParseError::Kind::InvalidLiteral);
             }
-            ASSERT(in[pos] == '"');
-            pos++;
-            return json_decode(
-                std::string_view{in.data() + start + 1, in.data() + pos - 1});
+            return BasicJson{ctx.alloc_};
         }
-        static auto deserialize_number(std::string_view in, std::size_t &pos)
-            -> Json {
-            auto start = pos;
-            auto length = in.length();
-            if (pos < length && in[pos] == '-') {
-                pos++;
+        static auto deserialize_false(std::string_view    in,
+                                      std::size_t        &pos,
+                                      const ParseContext &ctx)
+            -> BasicJson {
+            if (!detail::expect_literal(in, pos, "false")) [[unlikely]] {
+                return fail(in, pos, ctx, ParseError::Kind::InvalidLiteral);
             }
-            while (pos < length && '0' <= in[pos] && in[pos] <= '9') {
-                pos++;
+            return {false, ctx.alloc_};
+        }
+        static auto deserialize_true(std::string_view    in,
+                                     std::size_t        &pos,
+                                     const ParseContext &ctx)
+            -> BasicJson {
+            if (!detail::expect_literal(in, pos, "true")) [[unlikely]] {
+                return fail(in, pos, ctx, ParseError::Kind::InvalidLiteral);
             }
-            if (pos < length && in[pos] == '.') {
-                pos++;
-                while (pos < length && '0' <= in[pos] && in[pos] <= '9') {
-                    pos++;
+            return {true, ctx.alloc_};
+        }
+        static auto deserialize_string(std::string_view    in,
+                                       std::size_t        &pos,
+                                       const ParseContext &ctx)
+            -> BasicJson {
+            ASSERT(in[pos] == '"');
+            auto start = pos++;
+            BasicJson ret{ctx.alloc_};
+            if (ctx.options_.borrow_strings) {
+                auto length = detail::plain_string_length(in, pos);
+                if (length <= std::numeric_limits<std::uint32_t>::max()) {
+                    ret.value_.borrow(in.substr(pos, length));
+                    pos += length + 1;
+                    return ret;
                 }
-                return std::stod(std::string{in.substr(start, pos - start)});
             }
-            return std::stoi(std::string{in.substr(start, pos - start)});
+            ret.value_.template to<String>();
+            pos = detail::decode_string(
+                in, pos, ret.value_.template as<String>());
+            if (pos == std::string_view::npos) [[unlikely]] {
+                pos = start;
+                return fail(
+                    in, pos, ctx, ParseError::Kind::UnterminatedString);
+            }
+            return ret;
+        }
+        static auto deserialize_number(std::string_view    in,
+                                       std::size_t        &pos,
+                                       const ParseContext &ctx)
+            -> BasicJson {
+            auto start = pos;
+            auto number = detail::parse_number(in, pos);
+            switch (number.kind_) {
+            case detail::Number::Kind::Int64:
+                return {number.int64_, ctx.alloc_};
+            case detail::Number::Kind::UInt64:
+                return {number.uint64_, ctx.alloc_};
+            case detail::Number::Kind::Double:
+                return {number.double_, ctx.alloc_};
+            default:
+                pos = start;
+                return fail(in, pos, ctx, ParseError::Kind::InvalidNumber);
+            }
         }
-        static auto deserialize_array(std::string_view in, std::size_t &pos)
-            -> Json {
-            Json ret;
-            ret.value_->to<Array>(); // array type
+        static auto deserialize_array(std::string_view    in,
+                                      std::size_t        &pos,
+                                      const ParseContext &ctx)
+            -> BasicJson {
+            using enum ParseError::Kind;
+            if (ctx.depth_ == ctx.options_.max_depth) [[unlikely]] {
+                return fail(in, pos, ctx, TooDeep);
+            }
+            ctx.depth_++;
+            BasicJson ret{ctx.alloc_};
+            ret.value_.template to<Array>(); // array type
 
             ASSERT(in[pos] == '[');
             pos++;
-            while (in[pos] != ']') {
-                // ret.value_->data_.array_->push_back(deserialize_from(in,
-                // pos)); // array may be uninitialized
-                ret.value_->as<Array>()->push_back(deserialize_from(in, pos));
-                if (in[pos] == ',') {
-                    pos++;
+            if (!detail::consume(in, pos, ']')) {
+                do {
+                    ret.value_.template as<Array>().push_back(
+                        deserialize_from(in, pos, ctx));
+                } while (detail::consume(in, pos, ','));
+                if (pos == in.length() || in[pos] != ']') [[unlikely]] {
+                    return fail(in,
+                                pos,
+                                ctx,
+                                pos == in.length() ? UnexpectedEnd
+                                                   : ExpectedCommaOrBracket);
                 }
-                eat_whitespace(in, pos);
+                pos++;
             }
-            ASSERT(in[pos] == ']');
-            pos++;
+            ctx.depth_--;
             return ret;
         }
-        static auto deserialize_object(std::string_view in, std::size_t &pos)
-            -> Json {
-            Json ret;
-            ret.value_->to<Object>();
+        static auto deserialize_object(std::string_view    in,
+                                       std::size_t        &pos,
+                                       const ParseContext &ctx)
+            -> BasicJson {
+            using enum ParseError::Kind;
+            if (ctx.depth_ == ctx.options_.max_depth) [[unlikely]] {
+                return fail(in, pos, ctx, TooDeep);
+            }
+            ctx.depth_++;
+            BasicJson ret{ctx.alloc_};
+            ret.value_.template to<Object>();
 
             ASSERT(in[pos] == '{');
             pos++;
-            while (in[pos] != '}') {
-                eat_whitespace(in, pos);
-                auto key = deserialize_string(in, pos);
-                ASSERT(in[pos] == ':');
-                pos++;
-                eat_whitespace(in, pos);
-                auto value = deserialize_from(in, pos);
-                (*ret.value_
-                      ->as<Object>())[std::string{key.value_->as<String>()}]
-                    = value;
-                if (in[pos] == ',') {
-                    pos++;
+            if (!detail::consume(in, pos, '}')) {
+                do {
+                    detail::eat_whitespace(in, pos);
+                    if (pos == in.length() || in[pos] != '"') [[unlikely]] {
+                        return fail(in,
+                                    pos,
+                                    ctx,
+                                    pos == in.length() ? UnexpectedEnd
+                                                       : ExpectedKey);
+                    }
+                    auto     key_start = pos;
+                    string_t key{ctx.alloc_};
+                    pos = detail::decode_string(in, pos + 1, key);
+                    if (pos == std::string_view::npos) [[unlikely]] {
+                        pos = key_start;
+                        return fail(in, pos, ctx, UnterminatedString);
+                    }
+                    if (!detail::consume(in, pos, ':')) [[unlikely]] {
+                        return fail(in,
+                                    pos,
+                                    ctx,
+                                    pos == in.length() ? UnexpectedEnd
+                                                       : ExpectedColon);
+                    }
+                    auto value = deserialize_from(in, pos, ctx);
+                    ret.value_.template as<Object>().insert_or_assign(
+                        std::move(key), std::move(value));
+                } while (detail::consume(in, pos, ','));
+                // skip '}'
+                if (pos == in.length() || in[pos] != '}') [[unlikely]] {
+                    return fail(in,
+                                pos,
+                                ctx,
+                                pos == in.length() ? UnexpectedEnd
+                                                   : ExpectedCommaOrBrace);
                 }
-                eat_whitespace(in, pos);
+                pos++;
             }
-            // skip '}'
-            ASSERT(in[pos] == '}');
-            pos++;
-
+            ctx.depth_--;
             return ret;
         }
     };
 
 public:
-    Json([[maybe_unused]] std::nullptr_t null = nullptr)
-        : value_{std::make_shared<Value>()} {}
+    // Makes BasicJson allocator-aware: allocators that perform uses-allocator
+    // construction (std::pmr) hand their resource down to every child node.
+    using allocator_type = Allocator;
+
+    BasicJson([[maybe_unused]] std::nullptr_t null = nullptr) {}
+
+    explicit BasicJson(const Allocator &alloc)
+        : value_(alloc) {}
+
+    BasicJson(const BasicJson &other) = default;
+    BasicJson(BasicJson &&other) noexcept = default;
+
+    BasicJson(const BasicJson &other, const Allocator &alloc)
+        : value_(other.value_, alloc) {}
+
+    BasicJson(BasicJson &&other, const Allocator &alloc)
+        : value_(alloc) {
+        value_ = std::move(other.value_);
+    }
+
+    auto operator=(const BasicJson &other) -> BasicJson & = default;
+    auto operator=(BasicJson &&other) -> BasicJson & = default;
 
     template <typename T>
         requires(std::is_same_v<T, bool> || std::is_floating_point_v<T>
                  || std::is_integral_v<T>
                  || std::convertible_to<T, std::string_view>
                  || std::is_same_v<T, Value>)
-    Json(T value)
-        : value_{std::make_shared<Value>(value)} {}
+    BasicJson(T value, const Allocator &alloc = Allocator())
+        : value_(std::move(value), alloc) {}
 
-    Json(std::initializer_list<Json> values)
-        : value_{std::make_shared<Value>(values)} {}
+    BasicJson(std::initializer_list<BasicJson> values,
+              const Allocator                 &alloc = Allocator())
+        : value_(values, alloc) {}
 
-    Json(Json &&other) noexcept
-        : value_{std::move(other.value_)} {
-        other.value_ = nullptr;
+    // Assigning a scalar or string keeps this node's allocator.
+    auto operator=([[maybe_unused]] std::nullptr_t null) -> BasicJson & {
+        value_ = Value(value_.alloc_);
+        return *this;
     }
 
-    auto operator=(Json &&other) noexcept -> Json & {
-        if (std::addressof(other) != this) {
-            value_ = std::move(other.value_);
-            other.value_ = nullptr;
-        }
+    template <typename T>
+        requires(std::is_same_v<T, bool> || std::is_floating_point_v<T>
+                 || std::is_integral_v<T>
+                 || std::convertible_to<T, std::string_view>)
+    auto operator=(T value) -> BasicJson & {
+        value_ = Value(std::move(value), value_.alloc_);
         return *this;
     }
 
-    Json(const Json &other) = default;
-    auto operator=(const Json &other) -> Json & = default;
-
-    auto operator[](const std::string &key) -> Json & {
-        if (!value_->is<Object>()) {
-            value_->to<Object>();
+    auto operator[](std::string_view key) -> BasicJson & {
+        if (!value_.template is<Object>()) {
+            value_.template to<Object>();
         }
-        // auto value = value_->as<Object>()->find(key);
-        // if (value != value_->as<Object>()->end()) {
-        //     return value->second;
-        // }
-
-        return (*value_->as<Object>())[key];
+        auto &object = value_.template as<Object>();
+        auto  it = object.find(key);
+        if (it == object.end()) {
+            it = object
+                     .try_emplace(string_t{key, value_.alloc_},
+                                  BasicJson{value_.alloc_})
+                     .first;
+        }
+        return it->second;
     }
 
-    auto operator==(const Json &another) const noexcept -> bool {
+    auto operator==(const BasicJson &another) const noexcept -> bool {
         return this->value_ == another.value_;
     }
 
 public:
     auto serialize() const -> std::string {
-        std::ostringstream out;
-        value_->serialize_to(out);
-        return out.str();
+        std::string out;
+        serialize_to(out);
+        return out;
+    }
+
+    // Appends to `out`; reusing one string across calls avoids reallocating
+    // the output buffer.
+    auto serialize_to(std::string &out) const -> void {
+        StringWriter writer{out};
+        value_.serialize_to(writer);
+    }
+
+    auto serialize_to(std::ostream &out) const -> void {
+        StreamWriter writer{out};
+        value_.serialize_to(writer);
     }
 
-    static auto deserialize(const std::string &str) -> Json {
+    // Serializes into any `Writer`, e.g. a BufferWriter over a fixed buffer.
+    template <Writer W>
+    auto serialize_to(W &out) const -> void {
+        value_.serialize_to(out);
+    }
+
+    static auto deserialize(std::string_view str,
+                            const Allocator &alloc = Allocator()) -> BasicJson {
+        return deserialize(str, ParseOptions{}, alloc);
+    }
+
+    static auto deserialize(std::string_view    str,
+                            const ParseOptions &options,
+                            const Allocator    &alloc = Allocator())
+        -> BasicJson {
         if (str.empty()) {
-            return {nullptr};
+            return BasicJson{alloc};
         }
-        // std::istringstream in{str};
         std::size_t pos = 0;
-        return Value::deserialize_from(str, pos);
+        return Value::deserialize_from(str, pos, {alloc, options});
+    }
+
+    // Parses `str` without asserting on malformed input: returns the tree,
+    // or why and where the input was rejected, including anything but
+    // whitespace after the value. Throws nothing, so it also builds with
+    // -fno-exceptions; valid input takes the same path as deserialize, where
+    // each check is one branch that is never taken.
+    static auto try_deserialize(std::string_view    str,
+                                const ParseOptions &options = ParseOptions{},
+                                const Allocator    &alloc = Allocator())
+        -> ParseResult<BasicJson> {
+        ParseError  error;
+        std::size_t pos = 0;
+        detail::eat_whitespace(str, pos);
+        if (pos == str.length()) [[unlikely]] {
+            error = {ParseError::Kind::UnexpectedEnd, pos};
+        }
+        auto value
+            = Value::deserialize_from(str, pos, {alloc, options, &error});
+        detail::eat_whitespace(str, pos);
+        if (pos != str.length() && error.kind == ParseError::Kind::None)
+            [[unlikely]] {
+            error = {ParseError::Kind::TrailingCharacters, pos};
+        }
+        if (error.kind != ParseError::Kind::None) [[unlikely]] {
+            detail::locate(str, error);
+            return detail::failure(error);
+        }
+        return value;
+    }
+
+    // Checks that `str` is exactly one JSON document, per the RFC 8259
+    // grammar and in well-formed UTF-8, without building a tree or
+    // allocating. Stricter than the parsers, which let leading zeros, stray
+    // escapes and raw control characters through.
+    static auto validate(std::string_view    str,
+                         const ParseOptions &options = ParseOptions{}) noexcept
+        -> bool {
+        return detail::validate(str, options.max_depth).kind
+               == ParseError::Kind::None;
+    }
+
+    // As above; on failure, also says why and where.
+    static auto validate(std::string_view    str,
+                         ParseError         &error,
+                         const ParseOptions &options = ParseOptions{}) -> bool {
+        error = detail::validate(str, options.max_depth);
+        if (error.kind != ParseError::Kind::None) [[unlikely]] {
+            detail::locate(str, error);
+            return false;
+        }
+        return true;
+    }
+
+    // Builds the tree from a StructuralIndex previously built over `str`.
+    static auto deserialize(std::string_view       str,
+                            const StructuralIndex &index,
+                            const ParseOptions    &options = ParseOptions{},
+                            const Allocator       &alloc = Allocator())
+        -> BasicJson {
+        if (index.size() == 0 && !index.too_large()) {
+            return BasicJson{alloc};
+        }
+        return deserialize_indexed(str, index, {alloc, options});
+    }
+
+    // As try_deserialize(str), from a StructuralIndex of `str`.
+    static auto try_deserialize(std::string_view       str,
+                                const StructuralIndex &index,
+                                const ParseOptions    &options = ParseOptions{},
+                                const Allocator       &alloc = Allocator())
+        -> ParseResult<BasicJson> {
+        ParseError error;
+        auto value = deserialize_indexed(str, index, {alloc, options, &error});
+        if (error.kind != ParseError::Kind::None) [[unlikely]] {
+            detail::locate(str, error);
+            return detail::failure(error);
+        }
+        return value;
+    }
+
+    // Parses a top-level array from its StructuralIndex, handing the elements
+    // out through `for_each(count, fn)`, which must call `fn(i)` once for
+    // every i < count and may do so concurrently (see deserialize_parallel).
+    // The allocator must then be thread-safe. Other documents are parsed as
+    // usual. Malformed input is reported as by try_deserialize: the first
+    // error in document order.
+    template <typename ForEach>
+    static auto deserialize_elements(std::string_view       str,
+                                     const StructuralIndex &index,
+                                     ForEach              &&for_each,
+                                     const ParseOptions    &options,
+                                     const Allocator       &alloc)
+        -> ParseResult<BasicJson> {
+        const auto &positions = index.positions();
+        if (positions.size() < 2 || str[positions.front()] != '['
+            || str[positions[1]] == ']' || !index.strings_closed()
+            || options.max_depth == 0) {
+            return try_deserialize(str, index, options, alloc);
+        }
+        // Index of the first position of each element: the one after the
+        // opening bracket and after every comma directly inside it.
+        std::vector<std::size_t> starts{1};
+        std::size_t              depth = 0;
+        std::size_t              i = 0;
+        for (; i < positions.size(); i++) {
+            switch (str[positions[i]]) {
+            case '[':
+            case '{':
+                depth++;
+                continue;
+            case ']':
+            case '}':
+                depth--;
+                break;
+            case ',':
+                if (depth == 1) {
+                    starts.push_back(i + 1);
+                }
+                continue;
+            default:
+                continue;
+            }
+            if (depth == 0) {
+                break;
+            }
+        }
+        if (i + 1 != positions.size() || str[positions[i]] != ']')
+            [[unlikely]] {
+            // Malformed; the sequential parser reports it.
+            return try_deserialize(str, index, options, alloc);
+        }
+
+        BasicJson ret{alloc};
+        ret.value_.template to<Array>();
+        auto &array = ret.value_.template as<Array>();
+        array.reserve(starts.size());
+        for (std::size_t n = 0; n < starts.size(); n++) {
+            array.push_back(BasicJson{alloc});
+        }
+        auto parse_element = [&](std::size_t element, ParseError &error) {
+            using enum ParseError::Kind;
+            // One context per element, as they may be parsed concurrently;
+            // each is one level inside the top-level array.
+            typename Value::ParseContext ctx{alloc, options, &error, 1};
+            // Each element ends at the comma or bracket after it.
+            const auto *next = positions.data() + starts[element];
+            const auto *end = element + 1 < starts.size()
+                                  ? positions.data() + starts[element + 1] - 1
+                                  : positions.data() + positions.size() - 1;
+            if (next == end) [[unlikely]] {
+                // nothing before the separator, as in "[1,]"
+                std::size_t pos = *end;
+                return Value::fail(str, pos, ctx, UnexpectedCharacter);
+            }
+            auto value = Value::deserialize_indexed(str, next, end, ctx);
+            if (next != end) [[unlikely]] {
+                return Value::fail(
+                    str, next, end, ctx, ExpectedCommaOrBracket);
+            }
+            return value;
+        };
+        // The first element that failed. Errors are rare, so instead of
+        // collecting them the workers only lower this, and that element is
+        // parsed again to report its error.
+        std::atomic<std::size_t> failed{starts.size()};
+        for_each(starts.size(), [&](std::size_t element) {
+            ParseError error;
+            array[element] = parse_element(element, error);
+            if (error.kind != ParseError::Kind::None) [[unlikely]] {
+                auto first = failed.load(std::memory_order_relaxed);
+                while (element < first
+                       && !failed.compare_exchange_weak(
+                           first, element, std::memory_order_relaxed)) {
+                }
+            }
+        });
+        if (failed != starts.size()) [[unlikely]] {
+            ParseError error;
+            parse_element(failed, error);
+            detail::locate(str, error);
+            return detail::failure(error);
+        }
+        return ret;
+    }
+
+    // The value of any number node as a double.
+    auto number() const -> double {
+        return value_.template number_as<double>();
     }
 
-    auto number() const {
-        return value_->as<Number>();
+    // Exact accessors for integer nodes; a Double is truncated.
+    auto int64() const -> std::int64_t {
+        return value_.template number_as<std::int64_t>();
     }
 
-    auto string() const {
-        return value_->as<String>();
+    auto uint64() const -> std::uint64_t {
+        return value_.template number_as<std::uint64_t>();
+    }
+
+    auto string() const -> std::string_view {
+        return value_.view();
+    }
+
+    auto get_allocator() const noexcept -> Allocator {
+        return value_.alloc_;
     }
 
 private:
-    std::shared_ptr<Value> value_;
+    friend class BasicStreamParser<Allocator>;
+
+    // A whole document from its StructuralIndex, up to the last position.
+    static auto deserialize_indexed(std::string_view                    str,
+                                    const StructuralIndex              &index,
+                                    const typename Value::ParseContext &ctx)
+        -> BasicJson {
+        using enum ParseError::Kind;
+        std::size_t pos = 0;
+        if (index.too_large()) [[unlikely]] {
+            return Value::fail(str, pos, ctx, TooLarge);
+        }
+        const auto *next = index.positions().data();
+        const auto *end = next + index.size();
+        if (!index.strings_closed()) [[unlikely]] {
+            // Only opening quotes are indexed, so the last one is unmatched.
+            while (str[*(end - 1)] != '"') {
+                end--;
+            }
+            pos = *(end - 1);
+            return Value::fail(str, pos, ctx, UnterminatedString);
+        }
+        auto value = Value::deserialize_indexed(str, next, end, ctx);
+        if (next != end) [[unlikely]] {
+            return Value::fail(str, next, end, ctx, TrailingCharacters);
+        }
+        return value;
+    }
+
+    // Children are owned by their container: copying a Json copies the whole
+    // subtree, and only strings and containers allocate.
+    Value value_;
 };
+
+using Json = BasicJson<>;
+
+namespace pmr {
+    using Json = BasicJson<std::pmr::polymorphic_allocator<char>>;
+} // namespace pmr
 } // namespace jsonlib
@@ -0,0 +1,356 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/parse_error.hpp"
+#include "jsonlib/simd.hpp"
+#include "jsonlib/tokenizer.hpp"
+
+namespace jsonlib {
+
+// On-demand access to a document: a LazyJson is a cursor to one value in the
+// caller's buffer, which must outlive it. Nothing is parsed up front;
+// navigating with operator[] or iteration scans only as far as needed, and
+// the values passed over are skipped by matching brackets and quotes without
+// being converted or allocated. Skipped values are therefore not validated;
+// where the input is cut short, lookups yield missing cursors and iteration
+// simply ends.
+class LazyJson {
+public:
+    class iterator;
+
+    // A cursor to the top-level value of `in`.
+    static auto parse(std::string_view in) -> LazyJson {
+        std::size_t pos = 0;
+        detail::eat_whitespace(in, pos);
+        return pos < in.length() ? LazyJson{in, pos, {}} : LazyJson{};
+    }
+
+    // A cursor that points nowhere: the result of looking up a missing key
+    // or index. Every lookup on it yields another missing cursor.
+    LazyJson() = default;
+
+    auto exists() const noexcept -> bool {
+        return !in_.empty();
+    }
+
+    auto is_null() const noexcept -> bool {
+        return peek() == 'n';
+    }
+
+    auto is_bool() const noexcept -> bool {
+        return peek() == 't' || peek() == 'f';
+    }
+
+    auto is_number() const noexcept -> bool {
+        return peek() == '-' || ('0' <= peek() && peek() <= '9');
+    }
+
+    auto is_string() const noexcept -> bool {
+        return peek() == '"';
+    }
+
+    auto is_array() const noexcept -> bool {
+        return peek() == '[';
+    }
+
+    auto is_object() const noexcept -> bool {
+        return peek() == '{';
+    }
+
+    // Member lookup; a missing cursor if this is not an object or has no
+    // such key.
+    auto operator[](std::string_view key) const -> LazyJson;
+
+    // Element lookup; a missing cursor if this is not an array or is too
+    // short.
+    auto operator[](std::size_t index) const -> LazyJson;
+
+    // Iterates over the elements of an array or the member values of an
+    // object (see `key()`); empty for anything else.
+    auto begin() const -> iterator;
+    auto end() const -> iterator;
+
+    // The decoded key of a member reached through an object.
+    auto key() const -> std::string {
+        std::string out;
+        if (!key_.empty()) {
+            detail::decode_string(key_, 1, out);
+        }
+        return out;
+    }
+
+    auto boolean() const -> bool {
+        ASSERT(is_bool());
+        return peek() == 't';
+    }
+
+    auto number() const -> double {
+        return to_number().number();
+    }
+
+    auto int64() const -> std::int64_t {
+        return to_number().int64();
+    }
+
+    auto uint64() const -> std::uint64_t {
+        return to_number().uint64();
+    }
+
+    auto string() const -> std::string {
+        ASSERT(is_string());
+        std::string out;
+        if (is_string()) {
+            detail::decode_string(in_, pos_ + 1, out);
+        }
+        return out;
+    }
+
+    // The exact text of this value, including quotes or brackets.
+    auto raw() const -> std::string_view {
+        if (!exists()) {
+            return {};
+        }
+        return in_.substr(pos_, skip_value(in_, pos_) - pos_);
+    }
+
+    // Parses this value, and only this value, into a tree. Values passed
+    // over by the cursor were never validated, so malformed input is
+    // reported here as by try_deserialize, with the offset, line and column
+    // counted in the whole buffer. A missing cursor yields UnexpectedEnd.
+    template <typename Allocator = std::allocator<char>>
+    auto materialize(const ParseOptions &options = ParseOptions{},
+                     const Allocator    &alloc = Allocator()) const
+        -> ParseResult<BasicJson<Allocator>> {
+        auto result = BasicJson<Allocator>::try_deserialize(raw(), options,
+                                                            alloc);
+        if (!result.has_value()) [[unlikely]] {
+            auto error = result.error();
+            error.offset += pos_;
+            detail::locate(in_, error);
+            return detail::failure(error);
+        }
+        return result;
+    }
+
+private:
+    friend class iterator;
+
+    LazyJson(std::string_view in, std::size_t pos, std::string_view key)
+        : in_{in}
+        , pos_{pos}
+        , key_{key} {}
+
+    auto peek() const noexcept -> char {
+        return exists() ? in_[pos_] : '\0';
+    }
+
+    auto to_number() const -> Json {
+        ASSERT(is_number());
+        std::size_t pos = pos_;
+        auto        number = detail::parse_number(in_, pos);
+        ASSERT_MSG(number.kind_ != detail::Number::Kind::Invalid,
+                   "invalid number");
+        switch (number.kind_) {
+        case detail::Number::Kind::Int64:
+            return number.int64_;
+        case detail::Number::Kind::UInt64:
+            return number.uint64_;
+        default:
+            return number.double_;
+        }
+    }
+
+    // Compares without decoding unless the raw key has escapes.
+    auto key_matches(std::string_view key) const -> bool {
+        auto body = key_.substr(1, key_.length() - 2);
+        if (body.find('\\') == std::string_view::npos) {
+            return body == key;
+        }
+        return this->key() == key;
+    }
+
+    // Returns the position after the string starting at `pos` (at its
+    // opening quote), or the end of the input if it is not terminated.
+    static auto skip_string(std::string_view in, std::size_t pos) noexcept
+        -> std::size_t {
+        auto end = detail::skip_string(in, pos + 1);
+        return end != std::string_view::npos ? end : in.length();
+    }
+
+    // Returns the position after the value starting at `pos`, which is in
+    // the input. Containers are skipped by counting brackets outside of
+    // strings; one left open ends with the input.
+    static auto skip_value(std::string_view in, std::size_t pos)
+        -> std::size_t {
+        switch (in[pos]) {
+        case '"':
+            return skip_string(in, pos);
+        case '{':
+        case '[': {
+            std::size_t depth = 0;
+            do {
+                switch (in[pos]) {
+                case '"':
+                    pos = skip_string(in, pos);
+                    continue;
+                case '{':
+                case '[':
+                    depth++;
+                    break;
+                case '}':
+                case ']':
+                    depth--;
+                    break;
+                default:
+                    break;
+                }
+                pos++;
+            } while (depth != 0 && pos < in.length());
+            return pos;
+        }
+        default:
+            while (pos < in.length() && in[pos] != ',' && in[pos] != '}'
+                   && in[pos] != ']' && !simd::is_whitespace(in[pos])) {
+                pos++;
+            }
+            return pos;
+        }
+    }
+
+    std::string_view in_;
+    std::size_t      pos_{0};
+    // The quoted key when reached through an object member.
+    std::string_view key_;
+};
+
+class LazyJson::iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = LazyJson;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = LazyJson;
+
+    iterator() = default;
+
+    auto operator*() const -> LazyJson {
+        return current_;
+    }
+
+    // Anything but a comma after a value ends the iteration, as does the
+    // end of the input.
+    auto operator++() -> iterator & {
+        pos_ = LazyJson::skip_value(in_, current_.pos_);
+        if (detail::consume(in_, pos_, ',')) {
+            load();
+        } else {
+            in_ = {};
+        }
+        return *this;
+    }
+
+    auto operator++(int) -> iterator {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    // Iterators compare equal when both are at the end or at the same value.
+    auto operator==(const iterator &other) const noexcept -> bool {
+        return in_.data() == other.in_.data()
+               && (in_.empty() || current_.pos_ == other.current_.pos_);
+    }
+
+private:
+    friend class LazyJson;
+
+    // `pos` is just past the opening bracket.
+    iterator(std::string_view in, std::size_t pos, bool object)
+        : in_{in}
+        , pos_{pos}
+        , object_{object} {
+        if (detail::consume(in_, pos_, object_ ? '}' : ']')) {
+            in_ = {};
+        } else {
+            load();
+        }
+    }
+
+    // Reads the next member key (for objects) and positions on the value;
+    // ends the iteration if there is none.
+    auto load() -> void {
+        detail::eat_whitespace(in_, pos_);
+        std::string_view key;
+        if (object_) {
+            auto key_end = pos_ < in_.length() && in_[pos_] == '"'
+                               ? detail::skip_string(in_, pos_ + 1)
+                               : std::string_view::npos;
+            if (key_end == std::string_view::npos) [[unlikely]] {
+                in_ = {};
+                return;
+            }
+            key = in_.substr(pos_, key_end - pos_);
+            pos_ = key_end;
+            if (!detail::consume(in_, pos_, ':')) [[unlikely]] {
+                in_ = {};
+                return;
+            }
+        }
+        detail::eat_whitespace(in_, pos_);
+        if (pos_ == in_.length()) [[unlikely]] {
+            in_ = {};
+            return;
+        }
+        current_ = LazyJson{in_, pos_, key};
+    }
+
+    std::string_view in_;
+    std::size_t      pos_{0};
+    bool             object_{false};
+    LazyJson         current_;
+};
+
+inline auto LazyJson::begin() const -> iterator {
+    if (!is_array() && !is_object()) {
+        return {};
+    }
+    return {in_, pos_ + 1, is_object()};
+}
+
+inline auto LazyJson::end() const -> iterator {
+    return {};
+}
+
+inline auto LazyJson::operator[](std::string_view key) const -> LazyJson {
+    if (!is_object()) {
+        return {};
+    }
+    for (auto member : *this) {
+        if (member.key_matches(key)) {
+            return member;
+        }
+    }
+    return {};
+}
+
+inline auto LazyJson::operator[](std::size_t index) const -> LazyJson {
+    if (!is_array()) {
+        return {};
+    }
+    for (auto element : *this) {
+        if (index-- == 0) {
+            return element;
+        }
+    }
+    return {};
+}
+
+} // namespace jsonlib
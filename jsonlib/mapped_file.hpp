@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/parse_error.hpp"
+
+// Not included by jsonlib.hpp, since it pulls the POSIX headers into the
+// global namespace where mmap is available.
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define JSONLIB_HAS_MMAP 1
+#else
+#include <fstream>
+#include <iterator>
+#define JSONLIB_HAS_MMAP 0
+#endif
+
+namespace jsonlib {
+
+// A read-only view of a whole file, memory-mapped where the platform allows
+// it so that parsing reads the page cache directly instead of a copy. The
+// mapping lives as long as the MappedFile, which makes it a valid owner for
+// trees parsed with `borrow_strings`.
+//
+// No padding is needed past the end: every scanner is bounded by the end
+// pointer and finishes the last partial block byte by byte.
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    // Maps `path`; check `is_open()` for failure.
+    explicit MappedFile(const std::string &path) {
+#if JSONLIB_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) == 0) {
+            open_ = true;
+            size_ = static_cast<std::size_t>(st.st_size);
+        }
+        // mmap rejects empty mappings, but an empty file is still open.
+        if (open_ && size_ != 0) {
+            void *addr
+                = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                open_ = false;
+                size_ = 0;
+            } else {
+                data_ = static_cast<const char *>(addr);
+                // Parsers read front to back: ask for aggressive read-ahead.
+                ::madvise(addr, size_, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(fd);
+#else
+        std::ifstream in{path, std::ios::binary};
+        if (in) {
+            buffer_.assign(std::istreambuf_iterator<char>{in}, {});
+            open_ = true;
+            data_ = buffer_.data();
+            size_ = buffer_.size();
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    auto operator=(const MappedFile &) -> MappedFile & = delete;
+
+    MappedFile(MappedFile &&other) noexcept {
+        swap(other);
+    }
+
+    auto operator=(MappedFile &&other) noexcept -> MappedFile & {
+        MappedFile{std::move(other)}.swap(*this);
+        return *this;
+    }
+
+    ~MappedFile() {
+#if JSONLIB_HAS_MMAP
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char *>(data_), size_);
+        }
+#endif
+    }
+
+    auto is_open() const noexcept -> bool {
+        return open_;
+    }
+
+    auto view() const noexcept -> std::string_view {
+        return {data_, size_};
+    }
+
+private:
+    auto swap(MappedFile &other) noexcept -> void {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(open_, other.open_);
+#if !JSONLIB_HAS_MMAP
+        std::swap(buffer_, other.buffer_);
+        data_ = buffer_.data();
+        other.data_ = other.buffer_.data();
+#endif
+    }
+
+    const char *data_{nullptr};
+    std::size_t size_{0};
+    bool        open_{false};
+#if !JSONLIB_HAS_MMAP
+    std::string buffer_;
+#endif
+};
+
+// Parses a file straight from a read-only memory mapping instead of reading
+// it into a string first. Returns the tree, or why it could not be opened or
+// parsed. The mapping is released on return, so `borrow_strings` is
+// ignored: to keep zero-copy strings, hold a MappedFile for as long as the
+// tree and parse its view().
+template <typename Allocator = std::allocator<char>>
+auto deserialize_file(const std::string  &path,
+                      const ParseOptions &options = ParseOptions{},
+                      const Allocator    &alloc = Allocator())
+    -> ParseResult<BasicJson<Allocator>> {
+    MappedFile file{path};
+    if (!file.is_open()) [[unlikely]] {
+        return detail::failure(ParseError{ParseError::Kind::CannotOpenFile});
+    }
+    auto owned = options;
+    owned.borrow_strings = false;
+    return BasicJson<Allocator>::try_deserialize(file.view(), owned, alloc);
+}
+
+} // namespace jsonlib
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/parallel.hpp"
+#include "jsonlib/parse_error.hpp"
+#include "jsonlib/simd.hpp"
+
+namespace jsonlib {
+
+namespace detail {
+    // Splits newline-delimited input into its records, skipping blank lines.
+    inline auto split_records(std::string_view in)
+        -> std::vector<std::string_view> {
+        std::vector<std::string_view> records;
+        const auto *first = in.data();
+        const auto *last = in.data() + in.size();
+        while (first != last) {
+            auto        length = static_cast<std::size_t>(last - first);
+            const auto *newline = static_cast<const char *>(
+                std::memchr(first, '\n', length));
+            const auto *end = newline != nullptr ? newline : last;
+            if (simd::skip_whitespace(first, end) != end) {
+                records.emplace_back(first,
+                                     static_cast<std::size_t>(end - first));
+            }
+            first = newline != nullptr ? newline + 1 : last;
+        }
+        return records;
+    }
+} // namespace detail
+
+// Parses newline-delimited JSON (JSON Lines) in parallel and returns one
+// result per non-blank line, in input order: the value, or why the line was
+// rejected. A line must hold exactly one value; offsets, lines and columns
+// of an error count from the start of the line.
+template <typename Allocator = std::allocator<char>>
+auto parse_ndjson(std::string_view    in,
+                  const BatchOptions &options = BatchOptions{},
+                  const Allocator    &alloc = Allocator())
+    -> std::vector<ParseResult<BasicJson<Allocator>>> {
+    auto records = detail::split_records(in);
+    std::vector<ParseResult<BasicJson<Allocator>>> results(
+        records.size(), BasicJson<Allocator>{alloc});
+    detail::parallel_for(records.size(), options, [&](std::size_t i) {
+        results[i] = BasicJson<Allocator>::try_deserialize(
+            records[i], options.parse, alloc);
+    });
+    return results;
+}
+
+// Parses newline-delimited JSON in parallel and hands every record to
+// `on_record(index, result)` as soon as it is parsed, without keeping the
+// values. The callback runs concurrently on the worker threads, in no
+// particular order; `index` is the record's position among the non-blank
+// lines, and `result` holds its value or why it was rejected, as above.
+template <typename Fn>
+    requires std::invocable<Fn &, std::size_t, ParseResult<Json>>
+auto parse_ndjson(std::string_view    in,
+                  Fn                &&on_record,
+                  const BatchOptions &options = BatchOptions{}) -> void {
+    auto records = detail::split_records(in);
+    detail::parallel_for(records.size(), options, [&](std::size_t i) {
+        on_record(i, Json::try_deserialize(records[i], options.parse));
+    });
+}
+
+} // namespace jsonlib
@@ -0,0 +1,355 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace jsonlib {
+
+namespace detail {
+    // A sequence whose elements never move once added. They are stored in
+    // chunks of 2, 2, 4, 8, ... elements, so growing allocates about as
+    // often as a vector, but a reference to an element stays valid, as it
+    // would in a node-based map.
+    template <typename T, typename Allocator>
+    class StableVector {
+        template <typename U>
+        using allocator_for =
+            typename std::allocator_traits<Allocator>::template rebind_alloc<
+                U>;
+        using traits = std::allocator_traits<allocator_for<T>>;
+
+        static constexpr std::size_t first_chunk = 2;
+
+    public:
+        template <bool Const>
+        class basic_iterator;
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        explicit StableVector(const Allocator &alloc)
+            : alloc_{alloc}
+            , chunks_(alloc) {}
+
+        StableVector(const StableVector &other, const Allocator &alloc)
+            : StableVector(alloc) {
+            for (const auto &item : other) {
+                emplace_back(item);
+            }
+        }
+
+        StableVector(const StableVector &) = delete;
+        auto operator=(const StableVector &) -> StableVector & = delete;
+
+        ~StableVector() {
+            for (std::size_t i = 0; i < size_; i++) {
+                traits::destroy(alloc_, std::addressof((*this)[i]));
+            }
+            if (first_ != nullptr) {
+                traits::deallocate(alloc_, first_, first_chunk);
+            }
+            for (std::size_t k = 0; k < chunks_.size(); k++) {
+                traits::deallocate(alloc_, chunks_[k], chunk_size(k + 1));
+            }
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return size_;
+        }
+
+        auto empty() const noexcept -> bool {
+            return size_ == 0;
+        }
+
+        auto operator[](std::size_t pos) noexcept -> T & {
+            auto [chunk, offset] = locate(pos);
+            return (chunk == 0 ? first_ : chunks_[chunk - 1])[offset];
+        }
+
+        auto operator[](std::size_t pos) const noexcept -> const T & {
+            auto [chunk, offset] = locate(pos);
+            return (chunk == 0 ? first_ : chunks_[chunk - 1])[offset];
+        }
+
+        auto begin() noexcept -> iterator {
+            return {this, 0};
+        }
+
+        auto end() noexcept -> iterator {
+            return {this, size_};
+        }
+
+        auto begin() const noexcept -> const_iterator {
+            return {this, 0};
+        }
+
+        auto end() const noexcept -> const_iterator {
+            return {this, size_};
+        }
+
+        template <typename... Args>
+        auto emplace_back(Args &&...args) -> T & {
+            auto [chunk, offset] = locate(size_);
+            if (chunk == 0 && first_ == nullptr) {
+                first_ = traits::allocate(alloc_, first_chunk);
+            } else if (chunk != 0 && chunk > chunks_.size()) {
+                chunks_.reserve(chunk);
+                chunks_.push_back(traits::allocate(alloc_, chunk_size(chunk)));
+            }
+            T *slot = (chunk == 0 ? first_ : chunks_[chunk - 1]) + offset;
+            traits::construct(alloc_, slot, std::forward<Args>(args)...);
+            size_++;
+            return *slot;
+        }
+
+    private:
+        // Chunk k > 0 holds positions [2^k, 2^(k+1)) times first_chunk.
+        static auto locate(std::size_t pos) noexcept
+            -> std::pair<std::size_t, std::size_t> {
+            if (pos < first_chunk) {
+                return {0, pos};
+            }
+            auto chunk
+                = static_cast<std::size_t>(std::bit_width(pos / first_chunk));
+            return {chunk, pos - chunk_size(chunk)};
+        }
+
+        static constexpr auto chunk_size(std::size_t chunk) noexcept
+            -> std::size_t {
+            return chunk == 0 ? first_chunk : first_chunk << (chunk - 1);
+        }
+
+        [[no_unique_address]] allocator_for<T> alloc_;
+        std::size_t                            size_{0};
+        // Chunk 0 is held apart, so that small objects allocate no table.
+        T                                   *first_{nullptr};
+        std::vector<T *, allocator_for<T *>> chunks_;
+    };
+
+    template <typename T, typename Allocator>
+    template <bool Const>
+    class StableVector<T, Allocator>::basic_iterator {
+        using owner_t
+            = std::conditional_t<Const, const StableVector *, StableVector *>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T *, T *>;
+        using reference = std::conditional_t<Const, const T &, T &>;
+
+        basic_iterator() = default;
+        basic_iterator(const basic_iterator &) = default;
+        auto operator=(const basic_iterator &) -> basic_iterator & = default;
+
+        basic_iterator(const basic_iterator<false> &other) noexcept
+            requires Const
+            : owner_{other.owner_}
+            , pos_{other.pos_} {}
+
+        auto operator*() const noexcept -> reference {
+            return (*owner_)[pos_];
+        }
+
+        auto operator->() const noexcept -> pointer {
+            return std::addressof((*owner_)[pos_]);
+        }
+
+        auto operator++() noexcept -> basic_iterator & {
+            pos_++;
+            return *this;
+        }
+
+        auto operator++(int) noexcept -> basic_iterator {
+            auto copy = *this;
+            pos_++;
+            return copy;
+        }
+
+        auto operator+(std::size_t n) const noexcept -> basic_iterator {
+            return {owner_, pos_ + n};
+        }
+
+        auto operator==(const basic_iterator &other) const noexcept -> bool {
+            return pos_ == other.pos_;
+        }
+
+    private:
+        friend class StableVector;
+        friend class basic_iterator<!Const>;
+
+        basic_iterator(owner_t owner, std::size_t pos) noexcept
+            : owner_{owner}
+            , pos_{pos} {}
+
+        owner_t     owner_{nullptr};
+        std::size_t pos_{0};
+    };
+} // namespace detail
+
+// Object storage: members are kept in insertion order, at addresses that do
+// not change as members are added, so `obj["copy"] = obj["rgb"]` is safe.
+// Small objects are searched linearly; past `linear_search_limit` members an
+// open-addressing index of member positions is maintained next to them.
+template <typename Key, typename T, typename Allocator>
+class OrderedMap {
+    template <typename U>
+    using allocator_for =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<U>;
+
+public:
+    using value_type = std::pair<Key, T>;
+
+private:
+    using members_t = detail::StableVector<value_type, Allocator>;
+    using index_t = std::vector<std::uint32_t, allocator_for<std::uint32_t>>;
+
+public:
+    using iterator = typename members_t::iterator;
+    using const_iterator = typename members_t::const_iterator;
+
+    static constexpr std::size_t linear_search_limit = 16;
+
+    explicit OrderedMap(const Allocator &alloc)
+        : members_(alloc)
+        , index_(alloc) {}
+
+    OrderedMap(const OrderedMap &other, const Allocator &alloc)
+        : members_(other.members_, alloc)
+        , index_(other.index_, alloc) {}
+
+    auto begin() noexcept -> iterator {
+        return members_.begin();
+    }
+
+    auto end() noexcept -> iterator {
+        return members_.end();
+    }
+
+    auto begin() const noexcept -> const_iterator {
+        return members_.begin();
+    }
+
+    auto end() const noexcept -> const_iterator {
+        return members_.end();
+    }
+
+    auto size() const noexcept -> std::size_t {
+        return members_.size();
+    }
+
+    auto empty() const noexcept -> bool {
+        return members_.empty();
+    }
+
+    auto find(std::string_view key) -> iterator {
+        return members_.begin() + position(key);
+    }
+
+    auto find(std::string_view key) const -> const_iterator {
+        return members_.begin() + position(key);
+    }
+
+    template <typename K, typename V>
+    auto try_emplace(K &&key, V &&value) -> std::pair<iterator, bool> {
+        auto pos = position(key);
+        if (pos != members_.size()) {
+            return {members_.begin() + pos, false};
+        }
+        members_.emplace_back(std::forward<K>(key), std::forward<V>(value));
+        add_to_index(pos);
+        return {members_.begin() + pos, true};
+    }
+
+    template <typename K, typename V>
+    auto insert_or_assign(K &&key, V &&value) -> std::pair<iterator, bool> {
+        auto pos = position(key);
+        if (pos != members_.size()) {
+            members_[pos].second = std::forward<V>(value);
+            return {members_.begin() + pos, false};
+        }
+        members_.emplace_back(std::forward<K>(key), std::forward<V>(value));
+        add_to_index(pos);
+        return {members_.begin() + pos, true};
+    }
+
+    // Member order does not take part in the comparison.
+    auto operator==(const OrderedMap &other) const -> bool {
+        if (size() != other.size()) {
+            return false;
+        }
+        for (const auto &[key, value] : members_) {
+            auto it = other.find(key);
+            if (it == other.end() || !(it->second == value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    // Returns `size()` when the key is missing.
+    auto position(std::string_view key) const noexcept -> std::size_t {
+        if (index_.empty()) {
+            for (std::size_t i = 0; i < members_.size(); i++) {
+                if (members_[i].first == key) {
+                    return i;
+                }
+            }
+            return members_.size();
+        }
+
+        auto mask = index_.size() - 1;
+        for (auto slot = hash(key) & mask;; slot = (slot + 1) & mask) {
+            auto entry = index_[slot];
+            if (entry == 0) {
+                return members_.size();
+            }
+            if (members_[entry - 1].first == key) {
+                return entry - 1;
+            }
+        }
+    }
+
+    auto add_to_index(std::size_t pos) -> void {
+        if (members_.size() <= linear_search_limit) {
+            return;
+        }
+        // Keep the load factor at or below 1/2.
+        if (members_.size() * 2 > index_.size()) {
+            index_.assign(std::bit_ceil(members_.size() * 4), 0);
+            for (std::size_t i = 0; i < members_.size(); i++) {
+                insert_slot(i);
+            }
+            return;
+        }
+        insert_slot(pos);
+    }
+
+    auto insert_slot(std::size_t pos) noexcept -> void {
+        auto mask = index_.size() - 1;
+        auto slot = hash(members_[pos].first) & mask;
+        while (index_[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        index_[slot] = static_cast<std::uint32_t>(pos + 1);
+    }
+
+    static auto hash(std::string_view key) noexcept -> std::size_t {
+        return std::hash<std::string_view>{}(key);
+    }
+
+    members_t members_;
+    // Slots hold member position + 1; zero marks an empty slot.
+    index_t index_;
+};
+
+} // namespace jsonlib
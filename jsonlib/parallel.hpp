@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/parse_error.hpp"
+#include "jsonlib/structural_index.hpp"
+
+namespace jsonlib {
+
+struct BatchOptions {
+    // Worker threads; 0 uses one per hardware thread.
+    unsigned threads = 0;
+    // Records (lines, or elements of a top-level array) claimed by a worker
+    // at a time. Small enough to balance uneven records, large enough that
+    // the shared counter is rarely touched.
+    std::size_t  chunk_records = 256;
+    ParseOptions parse{};
+};
+
+namespace detail {
+    // Runs `fn(i)` for every i < count on a pool of workers. Each worker
+    // claims the next `chunk` indices from a shared counter until none are
+    // left, so a worker held up by large records simply claims fewer chunks.
+    template <typename Fn>
+    auto parallel_for(std::size_t         count,
+                      const BatchOptions &options,
+                      Fn                 &&fn) -> void {
+        auto chunk = std::max<std::size_t>(options.chunk_records, 1);
+        auto threads = options.threads != 0
+                           ? options.threads
+                           : std::max(std::thread::hardware_concurrency(), 1U);
+        threads = static_cast<unsigned>(
+            std::min<std::size_t>(threads, (count + chunk - 1) / chunk));
+
+        std::atomic<std::size_t> next{0};
+        auto                     work = [&] {
+            while (true) {
+                auto first = next.fetch_add(chunk, std::memory_order_relaxed);
+                if (first >= count) {
+                    return;
+                }
+                auto last = std::min(first + chunk, count);
+                for (auto i = first; i < last; i++) {
+                    fn(i);
+                }
+            }
+        };
+        if (threads <= 1) {
+            work();
+            return;
+        }
+        std::vector<std::jthread> workers;
+        workers.reserve(threads - 1);
+        for (unsigned i = 1; i < threads; i++) {
+            workers.emplace_back(work);
+        }
+        // The calling thread works too; the jthreads join on destruction.
+        work();
+    }
+} // namespace detail
+
+// Parses a document whose top level is an array with its elements spread
+// over a pool of workers. A structural index locates the commas directly
+// inside the array; each element is then parsed straight into its slot, so
+// the result needs no merging. Anything other than a non-empty array is
+// parsed on the calling thread. The allocator must be thread-safe. Returns
+// the tree, or the first error in document order as try_deserialize would.
+template <typename Allocator = std::allocator<char>>
+auto try_deserialize_parallel(std::string_view    in,
+                              const BatchOptions &options = BatchOptions{},
+                              const Allocator    &alloc = Allocator())
+    -> ParseResult<BasicJson<Allocator>> {
+    auto index = StructuralIndex::build(in);
+    return BasicJson<Allocator>::deserialize_elements(
+        in,
+        index,
+        [&](std::size_t count, auto &&fn) {
+            detail::parallel_for(count, options, fn);
+        },
+        options.parse,
+        alloc);
+}
+
+// As above, for input known to be well-formed: malformed input fails an
+// assertion, like Json::deserialize, and yields null in release builds.
+template <typename Allocator = std::allocator<char>>
+auto deserialize_parallel(std::string_view    in,
+                          const BatchOptions &options = BatchOptions{},
+                          const Allocator    &alloc = Allocator())
+    -> BasicJson<Allocator> {
+    auto result = try_deserialize_parallel(in, options, alloc);
+    ASSERT_MSG(result.has_value(), "malformed JSON");
+    if (!result.has_value()) [[unlikely]] {
+        return BasicJson<Allocator>{alloc};
+    }
+    return std::move(*result);
+}
+
+} // namespace jsonlib
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+#if __has_include(<expected>)
+#include <expected>
+#endif
+
+namespace jsonlib {
+
+// Why and where a document was rejected. `line` and `column` are 1-based and
+// count bytes; they are only worked out once an error has been found.
+struct ParseError {
+    enum class Kind : std::uint8_t {
+        None,
+        UnexpectedEnd,
+        UnexpectedCharacter,
+        InvalidLiteral,
+        InvalidNumber,
+        UnterminatedString,
+        ExpectedKey,
+        ExpectedColon,
+        ExpectedCommaOrBracket,
+        ExpectedCommaOrBrace,
+        TooDeep,
+        TrailingCharacters,
+        // reported by validate(), which is stricter than the parser
+        InvalidEscape,
+        ControlCharacter,
+        InvalidUtf8,
+        // reported by read<T>: well-formed, but not a `T`
+        UnexpectedType,
+        // reported by the indexed parsers, whose positions are 32 bits
+        TooLarge,
+        // reported by deserialize_file
+        CannotOpenFile,
+    };
+
+    Kind        kind = Kind::None;
+    std::size_t offset = 0;
+    std::size_t line = 0;
+    std::size_t column = 0;
+
+    auto message() const noexcept -> std::string_view {
+        switch (kind) {
+        case Kind::None:
+            return "no error";
+        case Kind::UnexpectedEnd:
+            return "unexpected end of input";
+        case Kind::UnexpectedCharacter:
+            return "unexpected character";
+        case Kind::InvalidLiteral:
+            return "invalid literal";
+        case Kind::InvalidNumber:
+            return "invalid number";
+        case Kind::UnterminatedString:
+            return "unterminated string";
+        case Kind::ExpectedKey:
+            return "expected a key";
+        case Kind::ExpectedColon:
+            return "expected ':'";
+        case Kind::ExpectedCommaOrBracket:
+            return "expected ',' or ']'";
+        case Kind::ExpectedCommaOrBrace:
+            return "expected ',' or '}'";
+        case Kind::TooDeep:
+            return "nesting too deep";
+        case Kind::TrailingCharacters:
+            return "unexpected data after the document";
+        case Kind::InvalidEscape:
+            return "invalid escape sequence";
+        case Kind::ControlCharacter:
+            return "unescaped control character in a string";
+        case Kind::InvalidUtf8:
+            return "invalid UTF-8";
+        case Kind::UnexpectedType:
+            return "value of the wrong type";
+        case Kind::TooLarge:
+            return "input too large to index";
+        case Kind::CannotOpenFile:
+            return "cannot open the file";
+        }
+        return "unknown error";
+    }
+};
+
+#if defined(__cpp_lib_expected)
+template <typename T>
+using ParseResult = std::expected<T, ParseError>;
+#else
+// The subset of std::expected<T, ParseError> used with try_deserialize, for
+// standard libraries that do not ship <expected> yet.
+template <typename T>
+class ParseResult {
+public:
+    ParseResult(T value)
+        // not braces: BasicJson{json} is an array holding `json`
+        : value_(std::move(value))
+        , has_value_{true} {}
+
+    ParseResult(ParseError error)
+        : error_{error} {}
+
+    auto has_value() const noexcept -> bool {
+        return has_value_;
+    }
+
+    explicit operator bool() const noexcept {
+        return has_value_;
+    }
+
+    auto value() & -> T & {
+        return value_;
+    }
+
+    auto value() const & -> const T & {
+        return value_;
+    }
+
+    auto value() && -> T && {
+        return std::move(value_);
+    }
+
+    auto operator*() & -> T & {
+        return value_;
+    }
+
+    auto operator*() const & -> const T & {
+        return value_;
+    }
+
+    auto operator->() -> T * {
+        return &value_;
+    }
+
+    auto operator->() const -> const T * {
+        return &value_;
+    }
+
+    auto error() const noexcept -> const ParseError & {
+        return error_;
+    }
+
+private:
+    T          value_{};
+    ParseError error_;
+    bool       has_value_{false};
+};
+#endif
+
+namespace detail {
+    // The error alternative of a ParseResult.
+    inline auto failure(const ParseError &error) {
+#if defined(__cpp_lib_expected)
+        return std::unexpected<ParseError>{error};
+#else
+        return error;
+#endif
+    }
+
+    // Fills in the line and column of `error.offset` within `in`.
+    inline auto locate(std::string_view in, ParseError &error) -> void {
+        auto before = in.substr(0, error.offset);
+        auto line_start = before.rfind('\n');
+        line_start = line_start == std::string_view::npos ? 0 : line_start + 1;
+        error.line = static_cast<std::size_t>(
+                         std::count(before.begin(), before.end(), '\n'))
+                     + 1;
+        error.column = error.offset - line_start + 1;
+    }
+} // namespace detail
+
+} // namespace jsonlib
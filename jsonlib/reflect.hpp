@@ -0,0 +1,678 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/parse_error.hpp"
+#include "jsonlib/tokenizer.hpp"
+#include "jsonlib/writer.hpp"
+
+// Compile-time reflection for plain structs. The fields of a struct are
+// listed once, next to its definition and in the same namespace:
+//
+//     struct Point {
+//         int         x;
+//         int         y;
+//         std::string label;
+//     };
+//     JSONLIB_REFLECT(Point, x, y, label)
+//
+// after which `jsonlib::serialize(point)` writes it straight to the output
+// as {"x": 1, "y": 2, "label": "..."}, without building a Json tree. Keys
+// are string literals assembled by the preprocessor, already quoted and
+// preceded by their separator, so every field costs one write for its key.
+namespace jsonlib {
+
+template <typename T, typename M>
+struct Field {
+    using Member = M T::*;
+
+    // `, "name": `; the first field skips the separator
+    std::string_view key_;
+    Member           member_;
+
+    constexpr auto name() const noexcept -> std::string_view {
+        return key_.substr(3, key_.size() - 6);
+    }
+};
+
+// The fields of `T`, as listed by JSONLIB_REFLECT.
+template <typename T>
+concept Reflected = requires(const T *p) {
+    { jsonlib_fields(p) };
+};
+
+namespace detail {
+    template <typename T>
+    concept StringLike = std::convertible_to<const T &, std::string_view>;
+
+    template <typename T>
+    concept KeyValueRange
+        = std::ranges::input_range<T>
+          && requires(std::ranges::range_reference_t<const T> item) {
+                 { item.first } -> std::convertible_to<std::string_view>;
+                 item.second;
+             };
+
+    template <typename T>
+    struct IsOptional : std::false_type {};
+
+    template <typename T>
+    struct IsOptional<std::optional<T>> : std::true_type {};
+
+    template <typename T>
+    struct IsBasicJson : std::false_type {};
+
+    template <typename Allocator>
+    struct IsBasicJson<BasicJson<Allocator>> : std::true_type {};
+
+    template <Writer W, typename T>
+    auto write_value(W &out, const T &value) -> void {
+        if constexpr (Reflected<T>) {
+            bool first = true;
+            out.put('{');
+            std::apply(
+                [&](const auto &...fields) {
+                    ((out.write(first ? fields.key_.substr(2) : fields.key_),
+                      write_value(out, value.*fields.member_),
+                      first = false),
+                     ...);
+                },
+                jsonlib_fields(&value));
+            out.put('}');
+        } else if constexpr (IsBasicJson<T>::value) {
+            value.serialize_to(out);
+        } else if constexpr (std::same_as<T, bool>) {
+            out.write(value ? "true" : "false");
+        } else if constexpr (std::same_as<T, std::nullptr_t>) {
+            out.write("null");
+        } else if constexpr (std::signed_integral<T>) {
+            write_number(out, static_cast<std::int64_t>(value));
+        } else if constexpr (std::unsigned_integral<T>) {
+            write_number(out, static_cast<std::uint64_t>(value));
+        } else if constexpr (std::floating_point<T>) {
+            write_number(out, static_cast<double>(value));
+        } else if constexpr (StringLike<T>) {
+            write_escaped(out, std::string_view{value});
+        } else if constexpr (IsOptional<T>::value) {
+            if (value) {
+                write_value(out, *value);
+            } else {
+                out.write("null");
+            }
+        } else if constexpr (KeyValueRange<T>) {
+            bool first = true;
+            out.put('{');
+            for (const auto &[key, item] : value) {
+                if (!first) {
+                    out.write(", ");
+                }
+                first = false;
+                write_escaped(out, std::string_view{key});
+                out.write(": ");
+                write_value(out, item);
+            }
+            out.put('}');
+        } else if constexpr (std::ranges::input_range<T>) {
+            bool first = true;
+            out.put('[');
+            for (const auto &item : value) {
+                if (!first) {
+                    out.write(", ");
+                }
+                first = false;
+                write_value(out, item);
+            }
+            out.put(']');
+        } else {
+            static_assert(sizeof(T) == 0,
+                          "no JSON representation; use JSONLIB_REFLECT");
+        }
+    }
+} // namespace detail
+
+// Serializes `value` into any `Writer`: reflected structs become objects,
+// ranges arrays (objects when their elements are key/value pairs with
+// string keys), optionals their value or null.
+template <Writer W, typename T>
+auto serialize_to(W &out, const T &value) -> void {
+    detail::write_value(out, value);
+}
+
+// Appends to `out`; reusing one string across calls avoids reallocating the
+// output buffer.
+template <typename T>
+auto serialize_to(std::string &out, const T &value) -> void {
+    StringWriter writer{out};
+    detail::write_value(writer, value);
+}
+
+template <typename T>
+auto serialize(const T &value) -> std::string {
+    std::string out;
+    serialize_to(out, value);
+    return out;
+}
+
+namespace detail {
+    constexpr auto hash_key(std::string_view key, std::uint64_t seed) noexcept
+        -> std::uint64_t {
+        // FNV-1a
+        auto hash = seed ^ 0xcbf2'9ce4'8422'2325ULL;
+        for (auto c : key) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100'0000'01b3ULL;
+        }
+        return hash ^ (hash >> 32);
+    }
+
+    // A perfect hash of the field names of `T`, built at compile time by
+    // hash and displace: names are split into buckets by one hash, then each
+    // bucket, fullest first, gets the first seed that sends its names to free
+    // slots. A key is looked up with two hashes and one string comparison.
+    // Should a bucket find no seed within `max_attempts`, lookups fall back
+    // to comparing every name.
+    template <Reflected T>
+    struct FieldTable {
+        static constexpr auto fields
+            = jsonlib_fields(static_cast<const T *>(nullptr));
+        static constexpr std::size_t count
+            = std::tuple_size_v<std::remove_const_t<decltype(fields)>>;
+        static constexpr std::size_t size
+            = std::bit_ceil(std::max<std::size_t>(count * 2, 1));
+        static constexpr std::size_t buckets
+            = std::bit_ceil(std::max<std::size_t>(count / 2, 1));
+        static constexpr std::size_t npos = count;
+        static constexpr std::size_t max_attempts = 4096;
+
+        static constexpr auto names = std::apply(
+            [](const auto &...field) {
+                return std::array<std::string_view, count>{field.name()...};
+            },
+            fields);
+
+        static constexpr auto bucket_of(std::string_view key) noexcept
+            -> std::size_t {
+            return hash_key(key, 0) & (buckets - 1);
+        }
+
+        struct Layout {
+            // bucket -> seed
+            std::array<std::uint64_t, buckets> seeds{};
+            // slot -> field index, npos where empty
+            std::array<std::size_t, size> slots{};
+            bool                          perfect{true};
+        };
+
+        static constexpr auto layout = [] {
+            Layout layout;
+            layout.slots.fill(npos);
+            std::array<std::size_t, buckets> order{};
+            std::array<std::size_t, buckets> fill{};
+            for (std::size_t i = 0; i < buckets; i++) {
+                order[i] = i;
+            }
+            for (auto name : names) {
+                fill[bucket_of(name)]++;
+            }
+            std::ranges::sort(order, [&](std::size_t a, std::size_t b) {
+                return fill[a] > fill[b];
+            });
+            for (auto bucket : order) {
+                std::array<std::size_t, count> members{};
+                std::size_t                    n = 0;
+                for (std::size_t i = 0; i < count; i++) {
+                    if (bucket_of(names[i]) == bucket) {
+                        members[n++] = i;
+                    }
+                }
+                if (n == 0) {
+                    break;
+                }
+                std::array<std::size_t, count> targets{};
+                bool                           placed = false;
+                for (std::uint64_t seed = 1; seed <= max_attempts && !placed;
+                     seed++) {
+                    placed = true;
+                    for (std::size_t j = 0; j < n && placed; j++) {
+                        targets[j]
+                            = hash_key(names[members[j]], seed) & (size - 1);
+                        placed = layout.slots[targets[j]] == npos
+                                 && std::find(targets.begin(),
+                                              targets.begin() + j,
+                                              targets[j])
+                                        == targets.begin() + j;
+                    }
+                    layout.seeds[bucket] = seed;
+                }
+                if (!placed) {
+                    layout.perfect = false;
+                    return layout;
+                }
+                for (std::size_t j = 0; j < n; j++) {
+                    layout.slots[targets[j]] = members[j];
+                }
+            }
+            return layout;
+        }();
+
+        // The index of the field called `key`, or npos.
+        static auto find(std::string_view key) noexcept -> std::size_t {
+            if constexpr (!layout.perfect) {
+                return static_cast<std::size_t>(
+                    std::ranges::find(names, key) - names.begin());
+            } else {
+                auto seed = layout.seeds[bucket_of(key)];
+                auto index = layout.slots[hash_key(key, seed) & (size - 1)];
+                if (index == npos || names[index] != key) {
+                    return npos;
+                }
+                return index;
+            }
+        }
+    };
+
+    template <typename T>
+    concept StringTarget = requires(T &out, const char *p) {
+        out.clear();
+        out.append(p, p);
+    };
+
+    template <typename T>
+    concept SequenceTarget = requires(T &out) { out.emplace_back(); };
+
+    template <typename T>
+    concept MapTarget
+        = requires(T &out, std::string_view key) {
+              typename T::mapped_type;
+              out.clear();
+              out[typename T::key_type{key}];
+          };
+
+    // Parses straight into typed values, building no Json nodes. Errors
+    // follow the DOM parser: the first one is recorded, or asserted when
+    // there is nowhere to record it, and the rest of the input is skipped.
+    class Reader {
+    public:
+        Reader(std::string_view    in,
+               const ParseOptions &options,
+               ParseError         *error) noexcept
+            : in_{in}
+            , options_{options}
+            , error_{error} {}
+
+        // Reads the whole input, which must hold exactly one value.
+        template <typename T>
+        auto read_document(T &out) -> void {
+            eat_whitespace(in_, pos_);
+            if (pos_ == in_.length()) [[unlikely]] {
+                fail(ParseError::Kind::UnexpectedEnd);
+                return;
+            }
+            read(out);
+            eat_whitespace(in_, pos_);
+            if (pos_ != in_.length()) [[unlikely]] {
+                fail(ParseError::Kind::TrailingCharacters);
+            }
+        }
+
+    private:
+        [[gnu::cold]] [[gnu::noinline]] auto
+        fail(ParseError::Kind kind) noexcept -> void {
+            if (error_ == nullptr) {
+                ASSERT_MSG(false, "malformed JSON");
+            } else if (error_->kind == ParseError::Kind::None) {
+                error_->kind = kind;
+                error_->offset = pos_;
+            }
+            failed_ = true;
+            pos_ = in_.length();
+        }
+
+        // Skips whitespace and fails unless a value starts next.
+        auto peek() -> bool {
+            eat_whitespace(in_, pos_);
+            if (pos_ == in_.length()) [[unlikely]] {
+                fail(ParseError::Kind::UnexpectedEnd);
+                return false;
+            }
+            return true;
+        }
+
+        template <typename T>
+        auto read(T &out) -> void {
+            if (!peek()) [[unlikely]] {
+                return;
+            }
+            if constexpr (Reflected<T>) {
+                read_members([&](std::string_view key) {
+                    using Table = FieldTable<T>;
+                    auto index = Table::find(key);
+                    if (index == Table::npos) {
+                        skip();
+                    } else {
+                        read_field(out,
+                                   index,
+                                   std::make_index_sequence<Table::count>{});
+                    }
+                });
+            } else if constexpr (IsBasicJson<T>::value) {
+                auto start = pos_;
+                skip();
+                if (!failed_) {
+                    out = T::deserialize(in_.substr(start, pos_ - start),
+                                         options_,
+                                         out.get_allocator());
+                }
+            } else if constexpr (std::same_as<T, bool>) {
+                if (expect_literal(in_, pos_, "true")) {
+                    out = true;
+                } else if (expect_literal(in_, pos_, "false")) {
+                    out = false;
+                } else {
+                    fail(ParseError::Kind::UnexpectedType);
+                }
+            } else if constexpr (std::is_arithmetic_v<T>) {
+                read_number(out);
+            } else if constexpr (StringTarget<T>) {
+                if (in_[pos_] != '"') [[unlikely]] {
+                    fail(ParseError::Kind::UnexpectedType);
+                    return;
+                }
+                auto start = pos_;
+                out.clear();
+                pos_ = decode_string(in_, pos_ + 1, out);
+                if (pos_ == std::string_view::npos) [[unlikely]] {
+                    pos_ = start;
+                    fail(ParseError::Kind::UnterminatedString);
+                }
+            } else if constexpr (IsOptional<T>::value) {
+                if (in_[pos_] == 'n') {
+                    if (!expect_literal(in_, pos_, "null")) [[unlikely]] {
+                        fail(ParseError::Kind::InvalidLiteral);
+                    }
+                    out.reset();
+                } else {
+                    read(out.emplace());
+                }
+            } else if constexpr (MapTarget<T>) {
+                out.clear();
+                read_members([&](std::string_view key) {
+                    read(out[typename T::key_type{key}]);
+                });
+            } else if constexpr (SequenceTarget<T>) {
+                out.clear();
+                read_elements([&] { read(out.emplace_back()); });
+            } else {
+                static_assert(sizeof(T) == 0,
+                              "cannot read this type; use JSONLIB_REFLECT");
+            }
+        }
+
+        template <typename T, std::size_t... I>
+        auto read_field(T &out, std::size_t index, std::index_sequence<I...>)
+            -> void {
+            constexpr auto &fields = FieldTable<T>::fields;
+            static_cast<void>(
+                ((index == I ? (read(out.*std::get<I>(fields).member_), true)
+                             : false)
+                 || ...));
+        }
+
+        template <typename T>
+        auto read_number(T &out) -> void {
+            using enum ParseError::Kind;
+            auto start = pos_;
+            auto number = parse_number(in_, pos_);
+            if (number.kind_ == Number::Kind::Invalid) [[unlikely]] {
+                pos_ = start;
+                fail(in_[pos_] == '-' || ('0' <= in_[pos_] && in_[pos_] <= '9')
+                         ? InvalidNumber
+                         : UnexpectedType);
+                return;
+            }
+            if constexpr (std::floating_point<T>) {
+                switch (number.kind_) {
+                case Number::Kind::Int64:
+                    out = static_cast<T>(number.int64_);
+                    break;
+                case Number::Kind::UInt64:
+                    out = static_cast<T>(number.uint64_);
+                    break;
+                default:
+                    out = static_cast<T>(number.double_);
+                    break;
+                }
+            } else {
+                // Integers must be written as integers that fit.
+                bool fits = (number.kind_ == Number::Kind::Int64
+                             && std::in_range<T>(number.int64_))
+                            || (number.kind_ == Number::Kind::UInt64
+                                && std::in_range<T>(number.uint64_));
+                if (!fits) [[unlikely]] {
+                    pos_ = start;
+                    fail(UnexpectedType);
+                    return;
+                }
+                out = number.kind_ == Number::Kind::Int64
+                          ? static_cast<T>(number.int64_)
+                          : static_cast<T>(number.uint64_);
+            }
+        }
+
+        // Consumes `open` at the start of a container, or fails.
+        auto enter(char open) -> bool {
+            if (in_[pos_] != open) [[unlikely]] {
+                fail(ParseError::Kind::UnexpectedType);
+                return false;
+            }
+            if (depth_ == options_.max_depth) [[unlikely]] {
+                fail(ParseError::Kind::TooDeep);
+                return false;
+            }
+            depth_++;
+            pos_++;
+            return true;
+        }
+
+        auto leave(char close, ParseError::Kind expected) -> void {
+            if (pos_ == in_.length() || in_[pos_] != close) [[unlikely]] {
+                fail(pos_ == in_.length() ? ParseError::Kind::UnexpectedEnd
+                                          : expected);
+                return;
+            }
+            pos_++;
+            depth_--;
+        }
+
+        // Calls `read_element()` for every element of the array that starts
+        // at `pos_`.
+        template <typename Fn>
+        auto read_elements(Fn read_element) -> void {
+            if (!enter('[')) [[unlikely]] {
+                return;
+            }
+            if (consume(in_, pos_, ']')) {
+                depth_--;
+                return;
+            }
+            do {
+                read_element();
+            } while (consume(in_, pos_, ','));
+            leave(']', ParseError::Kind::ExpectedCommaOrBracket);
+        }
+
+        // Calls `read_member(key)` with `pos_` at the value of every member
+        // of the object that starts at `pos_`.
+        template <typename Fn>
+        auto read_members(Fn read_member) -> void {
+            using enum ParseError::Kind;
+            if (!enter('{')) [[unlikely]] {
+                return;
+            }
+            if (consume(in_, pos_, '}')) {
+                depth_--;
+                return;
+            }
+            do {
+                eat_whitespace(in_, pos_);
+                if (pos_ == in_.length() || in_[pos_] != '"') [[unlikely]] {
+                    fail(pos_ == in_.length() ? UnexpectedEnd : ExpectedKey);
+                    return;
+                }
+                // Keys without escapes are looked up in place.
+                auto             start = pos_;
+                auto             length = plain_string_length(in_, pos_ + 1);
+                std::string_view key;
+                if (length != std::string_view::npos) {
+                    key = in_.substr(pos_ + 1, length);
+                    pos_ += length + 2;
+                } else {
+                    key_.clear();
+                    pos_ = decode_string(in_, pos_ + 1, key_);
+                    if (pos_ == std::string_view::npos) [[unlikely]] {
+                        pos_ = start;
+                        fail(UnterminatedString);
+                        return;
+                    }
+                    key = key_;
+                }
+                if (!consume(in_, pos_, ':')) [[unlikely]] {
+                    fail(pos_ == in_.length() ? UnexpectedEnd : ExpectedColon);
+                    return;
+                }
+                read_member(key);
+            } while (consume(in_, pos_, ','));
+            leave('}', ExpectedCommaOrBrace);
+        }
+
+        // Steps over one value, e.g. that of a key `T` does not have.
+        auto skip() -> void {
+            using enum ParseError::Kind;
+            if (!peek()) [[unlikely]] {
+                return;
+            }
+            auto start = pos_;
+            switch (in_[pos_]) {
+            case 'n':
+            case 't':
+            case 'f':
+                if (!expect_literal(in_, pos_, "null")
+                    && !expect_literal(in_, pos_, "true")
+                    && !expect_literal(in_, pos_, "false")) [[unlikely]] {
+                    fail(InvalidLiteral);
+                }
+                break;
+            case '"':
+                pos_ = skip_string(in_, pos_ + 1);
+                if (pos_ == std::string_view::npos) [[unlikely]] {
+                    pos_ = start;
+                    fail(UnterminatedString);
+                }
+                break;
+            case '[':
+                read_elements([&] { skip(); });
+                break;
+            case '{':
+                read_members([&](std::string_view) { skip(); });
+                break;
+            default:
+                if (parse_number(in_, pos_).kind_ == Number::Kind::Invalid)
+                    [[unlikely]] {
+                    pos_ = start;
+                    fail(in_[pos_] == '-'
+                                 || ('0' <= in_[pos_] && in_[pos_] <= '9')
+                             ? InvalidNumber
+                             : UnexpectedCharacter);
+                }
+                break;
+            }
+        }
+
+        std::string_view in_;
+        std::size_t      pos_{0};
+        ParseOptions     options_;
+        ParseError      *error_;
+        std::size_t      depth_{0};
+        bool             failed_{false};
+        // decoded keys with escapes
+        std::string key_;
+    };
+} // namespace detail
+
+// Parses `in` straight into a `T`: a reflected struct, a number, bool,
+// string, std::optional, sequence container (std::vector...), map with
+// string keys or Json. Object keys are matched against a struct's fields
+// through a compile-time perfect hash and unknown keys are skipped; fields
+// the input does not mention keep their default value, and a repeated key
+// replaces the value read before, containers included. No Json nodes are
+// built, except for members that are Json themselves.
+template <typename T>
+auto read(std::string_view in, const ParseOptions &options = ParseOptions{})
+    -> T {
+    T out{};
+    detail::Reader{in, options, nullptr}.read_document(out);
+    return out;
+}
+
+// As read<T>, but returns why and where the input was rejected instead of
+// asserting, including well-formed values of the wrong type.
+template <typename T>
+auto try_read(std::string_view in, const ParseOptions &options = ParseOptions{})
+    -> ParseResult<T> {
+    T          out{};
+    ParseError error;
+    detail::Reader{in, options, &error}.read_document(out);
+    if (error.kind != ParseError::Kind::None) [[unlikely]] {
+        detail::locate(in, error);
+        return detail::failure(error);
+    }
+    return out;
+}
+
+} // namespace jsonlib
+
+// Up to 256 fields: every rescan of JSONLIB_REFLECT_EXPAND expands one more
+// of them.
+#define JSONLIB_REFLECT_PARENS ()
+#define JSONLIB_REFLECT_EXPAND(...)                                            \
+    JSONLIB_REFLECT_EXPAND4(JSONLIB_REFLECT_EXPAND4(                           \
+        JSONLIB_REFLECT_EXPAND4(JSONLIB_REFLECT_EXPAND4(__VA_ARGS__))))
+#define JSONLIB_REFLECT_EXPAND4(...)                                           \
+    JSONLIB_REFLECT_EXPAND3(JSONLIB_REFLECT_EXPAND3(                           \
+        JSONLIB_REFLECT_EXPAND3(JSONLIB_REFLECT_EXPAND3(__VA_ARGS__))))
+#define JSONLIB_REFLECT_EXPAND3(...)                                           \
+    JSONLIB_REFLECT_EXPAND2(JSONLIB_REFLECT_EXPAND2(                           \
+        JSONLIB_REFLECT_EXPAND2(JSONLIB_REFLECT_EXPAND2(__VA_ARGS__))))
+#define JSONLIB_REFLECT_EXPAND2(...)                                           \
+    JSONLIB_REFLECT_EXPAND1(JSONLIB_REFLECT_EXPAND1(                           \
+        JSONLIB_REFLECT_EXPAND1(JSONLIB_REFLECT_EXPAND1(__VA_ARGS__))))
+#define JSONLIB_REFLECT_EXPAND1(...) __VA_ARGS__
+
+#define JSONLIB_REFLECT_FIELDS(type, field, ...)                               \
+    ::jsonlib::Field<type, decltype(type::field)>{", \"" #field "\": ",       \
+                                                  &type::field},               \
+        __VA_OPT__(JSONLIB_REFLECT_AGAIN JSONLIB_REFLECT_PARENS(type,          \
+                                                                __VA_ARGS__))
+#define JSONLIB_REFLECT_AGAIN() JSONLIB_REFLECT_FIELDS
+
+// Lists the fields of `type` for serialization, in output order. Use it at
+// namespace scope in the namespace of `type`, so that it is found by
+// argument-dependent lookup.
+#define JSONLIB_REFLECT(type, ...)                                             \
+    constexpr auto jsonlib_fields(const type *) {                              \
+        return std::tuple{__VA_OPT__(JSONLIB_REFLECT_EXPAND(                   \
+            JSONLIB_REFLECT_FIELDS(type, __VA_ARGS__)))};                      \
+    }
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/parse_error.hpp"
+#include "jsonlib/tokenizer.hpp"
+
+namespace jsonlib {
+
+// Event handler with a no-op for every event. Handlers passed to
+// `parse_events` only need the callbacks they use; deriving from this fills
+// in the rest. Callbacks may return bool instead of void, where false stops
+// the parse.
+struct EventHandler {
+    auto on_null() -> void {}
+    auto on_bool([[maybe_unused]] bool value) -> void {}
+    auto on_number([[maybe_unused]] std::int64_t value) -> void {}
+    auto on_number([[maybe_unused]] std::uint64_t value) -> void {}
+    auto on_number([[maybe_unused]] double value) -> void {}
+    // Strings and keys are views into the input, or into a scratch buffer
+    // when they contain escapes; either way only valid during the call.
+    auto on_string([[maybe_unused]] std::string_view value) -> void {}
+    auto on_key([[maybe_unused]] std::string_view key) -> void {}
+    auto on_start_object() -> void {}
+    auto on_end_object() -> void {}
+    auto on_start_array() -> void {}
+    auto on_end_array() -> void {}
+};
+
+namespace detail {
+    // Drives a handler over one document using the same token scanners as
+    // the DOM parser, without building any nodes. Malformed input stops the
+    // parse at the first error; events already delivered stand.
+    template <typename Handler>
+    class EventParser {
+    public:
+        EventParser(std::string_view in,
+                    Handler         &handler,
+                    std::size_t      max_depth)
+            : in_{in}
+            , handler_{handler}
+            , max_depth_{max_depth} {}
+
+        // Returns false if the handler stopped the parse or the input is
+        // malformed; `error()` tells the two apart.
+        auto parse_document() -> bool {
+            std::size_t pos = 0;
+            if (!parse_value(pos)) {
+                return false;
+            }
+            eat_whitespace(in_, pos);
+            if (pos != in_.length()) [[unlikely]] {
+                return fail(pos, ParseError::Kind::TrailingCharacters);
+            }
+            return true;
+        }
+
+        auto error() const noexcept -> const ParseError & {
+            return error_;
+        }
+
+    private:
+        template <typename Fn>
+        static auto notify(Fn fn) -> bool {
+            if constexpr (std::is_same_v<decltype(fn()), bool>) {
+                return fn();
+            } else {
+                fn();
+                return true;
+            }
+        }
+
+        [[gnu::cold]] auto fail(std::size_t pos, ParseError::Kind kind)
+            -> bool {
+            error_ = {kind, pos};
+            return false;
+        }
+
+        auto parse_value(std::size_t &pos) -> bool {
+            using enum ParseError::Kind;
+            eat_whitespace(in_, pos);
+            if (pos == in_.length()) [[unlikely]] {
+                return fail(pos, UnexpectedEnd);
+            }
+            switch (in_[pos]) {
+            case 'n':
+                return literal(pos, "null")
+                       && notify([&] { return handler_.on_null(); });
+            case 't':
+                return literal(pos, "true")
+                       && notify([&] { return handler_.on_bool(true); });
+            case 'f':
+                return literal(pos, "false")
+                       && notify([&] { return handler_.on_bool(false); });
+            case '-':
+            case '0':
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
+                return parse_number_value(pos);
+            case '"': {
+                std::string_view str;
+                return parse_string(pos, str)
+                       && notify([&] { return handler_.on_string(str); });
+            }
+            case '[':
+                return parse_array(pos);
+            case '{':
+                return parse_object(pos);
+            default:
+                return fail(pos, UnexpectedCharacter);
+            }
+        }
+
+        auto literal(std::size_t &pos, std::string_view text) -> bool {
+            return expect_literal(in_, pos, text)
+                   || fail(pos, ParseError::Kind::InvalidLiteral);
+        }
+
+        auto parse_number_value(std::size_t &pos) -> bool {
+            auto start = pos;
+            auto number = parse_number(in_, pos);
+            switch (number.kind_) {
+            case Number::Kind::Int64:
+                return notify(
+                    [&] { return handler_.on_number(number.int64_); });
+            case Number::Kind::UInt64:
+                return notify(
+                    [&] { return handler_.on_number(number.uint64_); });
+            case Number::Kind::Double:
+                return notify(
+                    [&] { return handler_.on_number(number.double_); });
+            default:
+                return fail(start, ParseError::Kind::InvalidNumber);
+            }
+        }
+
+        // `pos` is at the opening quote. Strings without escapes are handed
+        // out as views into the input.
+        auto parse_string(std::size_t &pos, std::string_view &str) -> bool {
+            auto start = pos++;
+            auto length = plain_string_length(in_, pos);
+            if (length != std::string_view::npos) {
+                str = in_.substr(pos, length);
+                pos += length + 1;
+                return true;
+            }
+            scratch_.clear();
+            pos = decode_string(in_, pos, scratch_);
+            if (pos == std::string_view::npos) [[unlikely]] {
+                return fail(start, ParseError::Kind::UnterminatedString);
+            }
+            str = scratch_;
+            return true;
+        }
+
+        // Consumes the closing `c` of a container, which must come next.
+        auto close(std::size_t &pos, char c, ParseError::Kind expected)
+            -> bool {
+            if (pos == in_.length() || in_[pos] != c) [[unlikely]] {
+                return fail(pos,
+                            pos == in_.length()
+                                ? ParseError::Kind::UnexpectedEnd
+                                : expected);
+            }
+            pos++;
+            depth_--;
+            return true;
+        }
+
+        auto parse_array(std::size_t &pos) -> bool {
+            if (depth_ == max_depth_) [[unlikely]] {
+                return fail(pos, ParseError::Kind::TooDeep);
+            }
+            depth_++;
+            pos++;
+            if (!notify([&] { return handler_.on_start_array(); })) {
+                return false;
+            }
+            if (consume(in_, pos, ']')) {
+                depth_--;
+            } else {
+                do {
+                    if (!parse_value(pos)) {
+                        return false;
+                    }
+                } while (consume(in_, pos, ','));
+                if (!close(
+                        pos, ']', ParseError::Kind::ExpectedCommaOrBracket)) {
+                    return false;
+                }
+            }
+            return notify([&] { return handler_.on_end_array(); });
+        }
+
+        auto parse_object(std::size_t &pos) -> bool {
+            using enum ParseError::Kind;
+            if (depth_ == max_depth_) [[unlikely]] {
+                return fail(pos, TooDeep);
+            }
+            depth_++;
+            pos++;
+            if (!notify([&] { return handler_.on_start_object(); })) {
+                return false;
+            }
+            if (consume(in_, pos, '}')) {
+                depth_--;
+            } else {
+                do {
+                    eat_whitespace(in_, pos);
+                    if (pos == in_.length() || in_[pos] != '"') [[unlikely]] {
+                        return fail(pos,
+                                    pos == in_.length() ? UnexpectedEnd
+                                                        : ExpectedKey);
+                    }
+                    std::string_view key;
+                    if (!parse_string(pos, key)
+                        || !notify([&] { return handler_.on_key(key); })) {
+                        return false;
+                    }
+                    if (!consume(in_, pos, ':')) [[unlikely]] {
+                        return fail(pos,
+                                    pos == in_.length() ? UnexpectedEnd
+                                                        : ExpectedColon);
+                    }
+                    if (!parse_value(pos)) {
+                        return false;
+                    }
+                } while (consume(in_, pos, ','));
+                if (!close(pos, '}', ExpectedCommaOrBrace)) {
+                    return false;
+                }
+            }
+            return notify([&] { return handler_.on_end_object(); });
+        }
+
+        std::string_view in_;
+        Handler         &handler_;
+        std::size_t      max_depth_;
+        // containers currently open
+        std::size_t depth_{0};
+        ParseError  error_;
+        // Holds the decoded form of the current escaped string or key.
+        std::string scratch_;
+    };
+} // namespace detail
+
+// Parses `in` and reports each value to `handler` as it is read, in document
+// order, without building a Json tree. The handler is a template parameter,
+// so its callbacks can be inlined. Returns false if a callback stopped the
+// parse early or the input is malformed; events up to the error have been
+// delivered by then. Nesting deeper than `options.max_depth` is rejected.
+template <typename Handler>
+auto parse_events(std::string_view    in,
+                  Handler            &handler,
+                  const ParseOptions &options = ParseOptions{}) -> bool {
+    return detail::EventParser<Handler>{in, handler, options.max_depth}
+        .parse_document();
+}
+
+// As above; `error` is of kind None if the parse completed or a callback
+// stopped it, and otherwise says why and where the input was rejected.
+template <typename Handler>
+auto parse_events(std::string_view    in,
+                  Handler            &handler,
+                  ParseError         &error,
+                  const ParseOptions &options = ParseOptions{}) -> bool {
+    detail::EventParser<Handler> parser{in, handler, options.max_depth};
+    auto                         completed = parser.parse_document();
+    error = parser.error();
+    if (error.kind != ParseError::Kind::None) [[unlikely]] {
+        detail::locate(in, error);
+    }
+    return completed;
+}
+
+} // namespace jsonlib
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define JSONLIB_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define JSONLIB_SIMD_X86 0
+#endif
+
+// Block scanners used by the parser. Each has a portable scalar version and,
+// on x86 with GCC/Clang, SSE2 and AVX2 versions picked once at runtime.
+// Vector loads never reach past `last`; the tail is handled by scalar code.
+namespace jsonlib::simd {
+
+constexpr auto is_whitespace(char c) noexcept -> bool {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+namespace detail {
+    using scan_fn = auto (*)(const char *first, const char *last) noexcept
+        -> const char *;
+
+    inline auto skip_whitespace_scalar(const char *first,
+                                       const char *last) noexcept
+        -> const char * {
+        while (first != last && is_whitespace(*first)) {
+            ++first;
+        }
+        return first;
+    }
+
+    inline auto find_quote_or_backslash_scalar(const char *first,
+                                               const char *last) noexcept
+        -> const char * {
+        while (first != last && *first != '"' && *first != '\\') {
+            ++first;
+        }
+        return first;
+    }
+
+    constexpr auto needs_escape(char c) noexcept -> bool {
+        return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+    }
+
+    inline auto find_escape_scalar(const char *first,
+                                   const char *last) noexcept -> const char * {
+        while (first != last && !needs_escape(*first)) {
+            ++first;
+        }
+        return first;
+    }
+
+#if JSONLIB_SIMD_X86
+    __attribute__((target("sse2"))) inline auto
+    whitespace_mask_sse2(__m128i chunk) noexcept -> unsigned {
+        auto ws = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')),
+                         _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')),
+                         _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))));
+        return static_cast<unsigned>(_mm_movemask_epi8(ws));
+    }
+
+    __attribute__((target("sse2"))) inline auto
+    skip_whitespace_sse2(const char *first, const char *last) noexcept
+        -> const char * {
+        while (last - first >= 16) {
+            auto chunk
+                = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+            auto other = ~whitespace_mask_sse2(chunk) & 0xffffU;
+            if (other != 0) {
+                return first + std::countr_zero(other);
+            }
+            first += 16;
+        }
+        return skip_whitespace_scalar(first, last);
+    }
+
+    __attribute__((target("sse2"))) inline auto
+    quote_or_backslash_mask_sse2(__m128i chunk) noexcept -> unsigned {
+        auto hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')),
+                                 _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+        return static_cast<unsigned>(_mm_movemask_epi8(hits));
+    }
+
+    __attribute__((target("sse2"))) inline auto
+    find_quote_or_backslash_sse2(const char *first, const char *last) noexcept
+        -> const char * {
+        while (last - first >= 16) {
+            auto chunk
+                = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+            auto hits = quote_or_backslash_mask_sse2(chunk);
+            if (hits != 0) {
+                return first + std::countr_zero(hits);
+            }
+            first += 16;
+        }
+        return find_quote_or_backslash_scalar(first, last);
+    }
+
+    // Control bytes are found with an unsigned compare: max(c, 0x1f) equals
+    // 0x1f exactly when c <= 0x1f.
+    __attribute__((target("sse2"))) inline auto
+    escape_mask_sse2(__m128i chunk) noexcept -> unsigned {
+        auto control = _mm_cmpeq_epi8(_mm_max_epu8(chunk, _mm_set1_epi8(0x1f)),
+                                      _mm_set1_epi8(0x1f));
+        auto hits = _mm_or_si128(
+            control,
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')),
+                         _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))));
+        return static_cast<unsigned>(_mm_movemask_epi8(hits));
+    }
+
+    __attribute__((target("sse2"))) inline auto
+    find_escape_sse2(const char *first, const char *last) noexcept
+        -> const char * {
+        while (last - first >= 16) {
+            auto chunk
+                = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+            auto hits = escape_mask_sse2(chunk);
+            if (hits != 0) {
+                return first + std::countr_zero(hits);
+            }
+            first += 16;
+        }
+        return find_escape_scalar(first, last);
+    }
+
+    __attribute__((target("avx2"))) inline auto
+    skip_whitespace_avx2(const char *first, const char *last) noexcept
+        -> const char * {
+        while (last - first >= 32) {
+            auto chunk
+                = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first));
+            auto ws = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')),
+                                _mm256_cmpeq_epi8(chunk,
+                                                  _mm256_set1_epi8('\n'))),
+                _mm256_or_si256(
+                    _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r')),
+                    _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))));
+            auto other = ~static_cast<unsigned>(_mm256_movemask_epi8(ws));
+            if (other != 0) {
+                return first + std::countr_zero(other);
+            }
+            first += 32;
+        }
+        return skip_whitespace_sse2(first, last);
+    }
+
+    __attribute__((target("avx2"))) inline auto
+    find_quote_or_backslash_avx2(const char *first, const char *last) noexcept
+        -> const char * {
+        while (last - first >= 32) {
+            auto chunk
+                = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first));
+            auto hits = _mm256_or_si256(
+                _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')),
+                _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\')));
+            auto mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+            if (mask != 0) {
+                return first + std::countr_zero(mask);
+            }
+            first += 32;
+        }
+        return find_quote_or_backslash_sse2(first, last);
+    }
+
+    __attribute__((target("avx2"))) inline auto
+    find_escape_avx2(const char *first, const char *last) noexcept
+        -> const char * {
+        while (last - first >= 32) {
+            auto chunk
+                = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first));
+            auto control = _mm256_cmpeq_epi8(
+                _mm256_max_epu8(chunk, _mm256_set1_epi8(0x1f)),
+                _mm256_set1_epi8(0x1f));
+            auto hits = _mm256_or_si256(
+                control,
+                _mm256_or_si256(
+                    _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')),
+                    _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'))));
+            auto mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+            if (mask != 0) {
+                return first + std::countr_zero(mask);
+            }
+            first += 32;
+        }
+        return find_escape_sse2(first, last);
+    }
+
+    inline auto has_avx2() noexcept -> bool {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }
+#endif
+
+    inline auto select_skip_whitespace() noexcept -> scan_fn {
+#if JSONLIB_SIMD_X86
+        if (has_avx2()) {
+            return skip_whitespace_avx2;
+        }
+        return skip_whitespace_sse2;
+#else
+        return skip_whitespace_scalar;
+#endif
+    }
+
+    inline auto select_find_quote_or_backslash() noexcept -> scan_fn {
+#if JSONLIB_SIMD_X86
+        if (has_avx2()) {
+            return find_quote_or_backslash_avx2;
+        }
+        return find_quote_or_backslash_sse2;
+#else
+        return find_quote_or_backslash_scalar;
+#endif
+    }
+
+    inline auto select_find_escape() noexcept -> scan_fn {
+#if JSONLIB_SIMD_X86
+        if (has_avx2()) {
+            return find_escape_avx2;
+        }
+        return find_escape_sse2;
+#else
+        return find_escape_scalar;
+#endif
+    }
+
+    // Function-local statics keep the dispatch usable during static
+    // initialization of other translation units.
+    inline auto skip_whitespace_dispatch(const char *first,
+                                         const char *last) noexcept
+        -> const char * {
+        static const scan_fn impl = select_skip_whitespace();
+        return impl(first, last);
+    }
+
+    inline auto find_quote_or_backslash_dispatch(const char *first,
+                                                 const char *last) noexcept
+        -> const char * {
+        static const scan_fn impl = select_find_quote_or_backslash();
+        return impl(first, last);
+    }
+
+    inline auto find_escape_dispatch(const char *first,
+                                     const char *last) noexcept
+        -> const char * {
+        static const scan_fn impl = select_find_escape();
+        return impl(first, last);
+    }
+} // namespace detail
+
+// Returns the first non-whitespace character in [first, last). Runs of zero
+// or one whitespace characters (minified input, "key": value) are handled
+// with two compares and indentation shorter than 16 bytes with one inline
+// SSE2 block; only longer runs go through the dispatched scanner.
+inline auto skip_whitespace(const char *first, const char *last) noexcept
+    -> const char * {
+    if (first == last || !is_whitespace(*first)) {
+        return first;
+    }
+    ++first;
+    if (first == last || !is_whitespace(*first)) {
+        return first;
+    }
+#if JSONLIB_SIMD_X86 && defined(__SSE2__)
+    if (last - first >= 16) {
+        auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+        auto other = ~detail::whitespace_mask_sse2(chunk) & 0xffffU;
+        if (other != 0) {
+            return first + std::countr_zero(other);
+        }
+        return detail::skip_whitespace_dispatch(first + 16, last);
+    }
+#endif
+    return detail::skip_whitespace_scalar(first, last);
+}
+
+// Returns the first '"' or '\\' in [first, last), or `last`.
+inline auto find_quote_or_backslash(const char *first,
+                                    const char *last) noexcept -> const char * {
+#if JSONLIB_SIMD_X86 && defined(__SSE2__)
+    if (last - first >= 16) {
+        auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+        auto hits = detail::quote_or_backslash_mask_sse2(chunk);
+        if (hits != 0) {
+            return first + std::countr_zero(hits);
+        }
+        return detail::find_quote_or_backslash_dispatch(first + 16, last);
+    }
+#endif
+    return detail::find_quote_or_backslash_scalar(first, last);
+}
+
+// Returns the first character in [first, last) that must be escaped inside a
+// JSON string ('"', '\\' or a control character), or `last`.
+inline auto find_escape(const char *first, const char *last) noexcept
+    -> const char * {
+#if JSONLIB_SIMD_X86 && defined(__SSE2__)
+    if (last - first >= 16) {
+        auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+        auto hits = detail::escape_mask_sse2(chunk);
+        if (hits != 0) {
+            return first + std::countr_zero(hits);
+        }
+        return detail::find_escape_dispatch(first + 16, last);
+    }
+#endif
+    return detail::find_escape_scalar(first, last);
+}
+
+} // namespace jsonlib::simd
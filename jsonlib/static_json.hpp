@@ -0,0 +1,941 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/json_codec.hpp"
+#include "jsonlib/tokenizer.hpp"
+#include "jsonlib/utf8.hpp"
+
+// JSON literals parsed by the compiler. `static_json<R"(...)">` is a table
+// of nodes built during constant evaluation and stored in the binary's
+// read-only data, so nothing is parsed at startup; a malformed literal fails
+// the build. The grammar is checked as strictly as by Json::validate.
+//
+//     constexpr auto defaults = jsonlib::static_json<R"({
+//         "retries": 3,
+//         "hosts": ["a.example", "b.example"]
+//     })">.root();
+//     static_assert(defaults["retries"].int64() == 3);
+namespace jsonlib {
+
+// A string literal as a template argument.
+template <std::size_t N>
+struct FixedString {
+    constexpr FixedString(const char (&str)[N]) noexcept {
+        for (std::size_t i = 0; i < N; i++) {
+            data_[i] = str[i];
+        }
+    }
+
+    constexpr auto view() const noexcept -> std::string_view {
+        return {data_, N - 1};
+    }
+
+    char data_[N]{};
+};
+
+// One value of a static document. The children of a container are stored
+// next to each other, so elements are indexed directly; objects store a key
+// node before every value.
+struct StaticNode {
+    enum class Type : std::uint8_t {
+        Null,
+        False,
+        True,
+        Int64,
+        UInt64,
+        Double,
+        String,
+        Array,
+        Object,
+    };
+
+    Type type_{Type::Null};
+    // String: length; Array: elements; Object: members
+    std::uint32_t size_{0};
+    // String: offset of the text; Array and Object: index of the first child
+    std::uint32_t offset_{0};
+    union {
+        std::int64_t  int64_{0};
+        std::uint64_t uint64_;
+        double        double_;
+    };
+};
+
+// A cursor to one value of a static document, with the interface of
+// LazyJson. Looking up a missing key or index yields a cursor that points
+// nowhere.
+class StaticJson {
+public:
+    using Type = StaticNode::Type;
+
+    class iterator;
+
+    constexpr StaticJson() = default;
+
+    constexpr StaticJson(const StaticNode *nodes,
+                         const char       *chars,
+                         std::uint32_t     index,
+                         std::uint32_t     key = npos) noexcept
+        : nodes_{nodes}
+        , chars_{chars}
+        , index_{index}
+        , key_{key} {}
+
+    constexpr auto exists() const noexcept -> bool {
+        return index_ != npos;
+    }
+
+    constexpr auto is_null() const noexcept -> bool {
+        return exists() && node().type_ == Type::Null;
+    }
+
+    constexpr auto is_bool() const noexcept -> bool {
+        return exists()
+               && (node().type_ == Type::True || node().type_ == Type::False);
+    }
+
+    constexpr auto is_number() const noexcept -> bool {
+        return exists()
+               && (node().type_ == Type::Int64 || node().type_ == Type::UInt64
+                   || node().type_ == Type::Double);
+    }
+
+    constexpr auto is_string() const noexcept -> bool {
+        return exists() && node().type_ == Type::String;
+    }
+
+    constexpr auto is_array() const noexcept -> bool {
+        return exists() && node().type_ == Type::Array;
+    }
+
+    constexpr auto is_object() const noexcept -> bool {
+        return exists() && node().type_ == Type::Object;
+    }
+
+    // Elements of an array or members of an object; 0 for anything else.
+    constexpr auto size() const noexcept -> std::size_t {
+        return is_array() || is_object() ? node().size_ : 0;
+    }
+
+    // Member lookup, comparing keys in order; a missing cursor if this is
+    // not an object or has no such key.
+    constexpr auto operator[](std::string_view key) const noexcept
+        -> StaticJson {
+        if (!is_object()) {
+            return {};
+        }
+        for (std::uint32_t i = 0; i < node().size_; i++) {
+            auto key_index = node().offset_ + 2 * i;
+            if (text(nodes_[key_index]) == key) {
+                return {nodes_, chars_, key_index + 1, key_index};
+            }
+        }
+        return {};
+    }
+
+    // Element lookup in constant time; a missing cursor if this is not an
+    // array or is too short.
+    constexpr auto operator[](std::size_t index) const noexcept
+        -> StaticJson {
+        if (!is_array() || index >= node().size_) {
+            return {};
+        }
+        return {nodes_,
+                chars_,
+                node().offset_ + static_cast<std::uint32_t>(index)};
+    }
+
+    // Iterates over the elements of an array or the member values of an
+    // object (see `key()`); empty for anything else.
+    constexpr auto begin() const noexcept -> iterator;
+    constexpr auto end() const noexcept -> iterator;
+
+    // The key of a member reached through an object.
+    constexpr auto key() const noexcept -> std::string_view {
+        return key_ != npos ? text(nodes_[key_]) : std::string_view{};
+    }
+
+    constexpr auto boolean() const noexcept -> bool {
+        ASSERT(is_bool());
+        return node().type_ == Type::True;
+    }
+
+    // The value of any number node as a double.
+    constexpr auto number() const noexcept -> double {
+        ASSERT(is_number());
+        switch (node().type_) {
+        case Type::Int64:
+            return static_cast<double>(node().int64_);
+        case Type::UInt64:
+            return static_cast<double>(node().uint64_);
+        default:
+            return node().double_;
+        }
+    }
+
+    // Exact accessors for integer nodes; a Double is truncated.
+    constexpr auto int64() const noexcept -> std::int64_t {
+        switch (node().type_) {
+        case Type::Int64:
+            return node().int64_;
+        case Type::UInt64:
+            return static_cast<std::int64_t>(node().uint64_);
+        default:
+            return static_cast<std::int64_t>(number());
+        }
+    }
+
+    constexpr auto uint64() const noexcept -> std::uint64_t {
+        switch (node().type_) {
+        case Type::Int64:
+            return static_cast<std::uint64_t>(node().int64_);
+        case Type::UInt64:
+            return node().uint64_;
+        default:
+            return static_cast<std::uint64_t>(number());
+        }
+    }
+
+    // Escapes are decoded at compile time.
+    constexpr auto string() const noexcept -> std::string_view {
+        ASSERT(is_string());
+        return text(node());
+    }
+
+private:
+    static constexpr std::uint32_t npos
+        = std::numeric_limits<std::uint32_t>::max();
+
+    constexpr auto node() const noexcept -> const StaticNode & {
+        return nodes_[index_];
+    }
+
+    constexpr auto text(const StaticNode &node) const noexcept
+        -> std::string_view {
+        return {chars_ + node.offset_, node.size_};
+    }
+
+    const StaticNode *nodes_{nullptr};
+    const char       *chars_{nullptr};
+    // npos for a missing cursor
+    std::uint32_t index_{npos};
+    std::uint32_t key_{npos};
+};
+
+class StaticJson::iterator {
+public:
+    using value_type = StaticJson;
+    using difference_type = std::ptrdiff_t;
+
+    constexpr iterator() = default;
+
+    constexpr iterator(StaticJson parent, std::uint32_t child) noexcept
+        : parent_{parent}
+        , child_{child} {}
+
+    constexpr auto operator*() const noexcept -> StaticJson {
+        if (parent_.is_object()) {
+            auto key_index = parent_.node().offset_ + 2 * child_;
+            return {parent_.nodes_, parent_.chars_, key_index + 1, key_index};
+        }
+        return {
+            parent_.nodes_, parent_.chars_, parent_.node().offset_ + child_};
+    }
+
+    constexpr auto operator++() noexcept -> iterator & {
+        child_++;
+        return *this;
+    }
+
+    constexpr auto operator++(int) noexcept -> iterator {
+        auto old = *this;
+        child_++;
+        return old;
+    }
+
+    constexpr auto operator==(const iterator &other) const noexcept -> bool {
+        return child_ == other.child_;
+    }
+
+private:
+    StaticJson    parent_;
+    std::uint32_t child_{0};
+};
+
+constexpr auto StaticJson::begin() const noexcept -> iterator {
+    return {*this, 0};
+}
+
+constexpr auto StaticJson::end() const noexcept -> iterator {
+    return {*this, static_cast<std::uint32_t>(size())};
+}
+
+// The node table of a static document and the text of its strings.
+template <std::size_t Nodes, std::size_t Chars>
+struct StaticDocument {
+    std::array<StaticNode, Nodes> nodes_{};
+    std::array<char, Chars>       chars_{};
+
+    constexpr auto root() const noexcept -> StaticJson {
+        return {nodes_.data(), chars_.data(), 0};
+    }
+};
+
+namespace detail {
+    // Deliberately not constexpr: reaching it during constant evaluation is
+    // what fails the build, with the failing check in the compiler's notes.
+    inline auto malformed_json_literal(std::size_t offset,
+                                       const char *message) -> void {
+        static_cast<void>(offset);
+        static_cast<void>(message);
+        ASSERT_MSG(false, "malformed JSON literal");
+    }
+
+    // An unsigned integer for the exact conversion of numbers during constant
+    // evaluation: 32-bit limbs, least significant first, without leading
+    // zero limbs. The capacity covers 801 significant digits times any
+    // power of five a double can need, plus the scaling of a division.
+    class StaticBigInt {
+    public:
+        static constexpr std::size_t capacity = 96;
+
+        constexpr StaticBigInt() = default;
+
+        constexpr explicit StaticBigInt(std::uint32_t value) noexcept {
+            if (value != 0) {
+                limbs_[size_++] = value;
+            }
+        }
+
+        constexpr auto is_zero() const noexcept -> bool {
+            return size_ == 0;
+        }
+
+        constexpr auto bit_width() const noexcept -> std::size_t {
+            return size_ == 0 ? 0
+                              : 32 * (size_ - 1)
+                                    + std::bit_width(limbs_[size_ - 1]);
+        }
+
+        // *this = *this * factor + addend
+        constexpr auto multiply_add(std::uint32_t factor,
+                                    std::uint32_t addend) noexcept -> void {
+            std::uint64_t carry = addend;
+            for (std::size_t i = 0; i < size_; i++) {
+                carry += std::uint64_t{limbs_[i]} * factor;
+                limbs_[i] = static_cast<std::uint32_t>(carry);
+                carry >>= 32;
+            }
+            if (carry != 0) {
+                limbs_[size_++] = static_cast<std::uint32_t>(carry);
+            }
+        }
+
+        constexpr auto multiply_pow5(int exponent) noexcept -> void {
+            // 5^13 is the largest power of five that fits 32 bits
+            for (; exponent >= 13; exponent -= 13) {
+                multiply_add(1'220'703'125, 0);
+            }
+            std::uint32_t factor = 1;
+            for (; exponent > 0; exponent--) {
+                factor *= 5;
+            }
+            multiply_add(factor, 0);
+        }
+
+        constexpr auto shift_left(std::size_t bits) noexcept -> void {
+            if (size_ == 0) {
+                return;
+            }
+            auto words = bits / 32;
+            bits %= 32;
+            if (bits != 0) {
+                limbs_[size_] = 0;
+                for (auto i = size_; i-- > 0;) {
+                    limbs_[i + 1] |= limbs_[i] >> (32 - bits);
+                    limbs_[i] <<= bits;
+                }
+                size_ += limbs_[size_] != 0 ? 1 : 0;
+            }
+            if (words != 0) {
+                for (auto i = size_; i-- > 0;) {
+                    limbs_[i + words] = limbs_[i];
+                }
+                for (std::size_t i = 0; i < words; i++) {
+                    limbs_[i] = 0;
+                }
+                size_ += words;
+            }
+        }
+
+        constexpr auto shift_right_one() noexcept -> void {
+            for (std::size_t i = 0; i + 1 < size_; i++) {
+                limbs_[i] = (limbs_[i] >> 1) | (limbs_[i + 1] << 31);
+            }
+            if (size_ != 0) {
+                limbs_[size_ - 1] >>= 1;
+                size_ -= limbs_[size_ - 1] == 0 ? 1 : 0;
+            }
+        }
+
+        // Requires other <= *this.
+        constexpr auto subtract(const StaticBigInt &other) noexcept -> void {
+            std::uint32_t borrow = 0;
+            for (std::size_t i = 0; i < size_; i++) {
+                std::uint64_t take = borrow;
+                take += i < other.size_ ? other.limbs_[i] : 0;
+                borrow = limbs_[i] < take ? 1 : 0;
+                limbs_[i] = static_cast<std::uint32_t>(limbs_[i] - take);
+            }
+            while (size_ != 0 && limbs_[size_ - 1] == 0) {
+                size_--;
+            }
+        }
+
+        friend constexpr auto operator<(const StaticBigInt &a,
+                                        const StaticBigInt &b) noexcept
+            -> bool {
+            if (a.size_ != b.size_) {
+                return a.size_ < b.size_;
+            }
+            for (auto i = a.size_; i-- > 0;) {
+                if (a.limbs_[i] != b.limbs_[i]) {
+                    return a.limbs_[i] < b.limbs_[i];
+                }
+            }
+            return false;
+        }
+
+    private:
+        std::array<std::uint32_t, capacity> limbs_{};
+        std::size_t                         size_{0};
+    };
+
+    struct StaticSize {
+        std::size_t nodes_;
+        std::size_t chars_;
+    };
+
+    // Parses a literal in two passes over the same grammar. The first one
+    // counts nodes and characters and the children of every container, in
+    // document order; the second lays the children of each container out
+    // next to each other, which needs their count up front.
+    class StaticParser {
+    public:
+        static constexpr auto measure(std::string_view in) -> StaticSize {
+            std::vector<std::uint32_t> counts;
+            StaticParser               parser{in, counts, nullptr, nullptr};
+            parser.parse_document();
+            return {parser.node_count_, parser.char_count_};
+        }
+
+        static constexpr auto
+        build(std::string_view in, StaticNode *nodes, char *chars) -> void {
+            std::vector<std::uint32_t> counts;
+            StaticParser{in, counts, nullptr, nullptr}.parse_document();
+            StaticParser{in, counts, nodes, chars}.parse_document();
+        }
+
+    private:
+        constexpr StaticParser(std::string_view            in,
+                               std::vector<std::uint32_t> &counts,
+                               StaticNode                 *nodes,
+                               char                       *chars) noexcept
+            : in_{in}
+            , counts_{&counts}
+            , nodes_{nodes}
+            , chars_{chars} {}
+
+        constexpr auto building() const noexcept -> bool {
+            return nodes_ != nullptr;
+        }
+
+        constexpr auto fail(const char *message) -> void {
+            if (std::is_constant_evaluated()) {
+                malformed_json_literal(pos_, message);
+            }
+            pos_ = in_.length();
+        }
+
+        constexpr auto allocate(std::uint32_t count) noexcept
+            -> std::uint32_t {
+            auto first = node_count_;
+            node_count_ += count;
+            return first;
+        }
+
+        constexpr auto put(char c) noexcept -> void {
+            if (building()) {
+                chars_[char_count_] = c;
+            }
+            char_count_++;
+        }
+
+        constexpr auto set(std::uint32_t slot, const StaticNode &node) noexcept
+            -> void {
+            if (building()) {
+                nodes_[slot] = node;
+            }
+        }
+
+        constexpr auto skip_whitespace() noexcept -> void {
+            while (pos_ < in_.length()
+                   && (in_[pos_] == ' ' || in_[pos_] == '\n'
+                       || in_[pos_] == '\r' || in_[pos_] == '\t')) {
+                pos_++;
+            }
+        }
+
+        constexpr auto consume(char c) noexcept -> bool {
+            skip_whitespace();
+            if (pos_ < in_.length() && in_[pos_] == c) {
+                pos_++;
+                return true;
+            }
+            return false;
+        }
+
+        constexpr auto parse_document() -> void {
+            allocate(1);
+            parse_value(0);
+            skip_whitespace();
+            if (pos_ != in_.length()) {
+                fail("unexpected data after the document");
+            }
+        }
+
+        constexpr auto parse_value(std::uint32_t slot) -> void {
+            using enum StaticNode::Type;
+            skip_whitespace();
+            if (pos_ == in_.length()) {
+                fail("unexpected end of input");
+                return;
+            }
+            switch (in_[pos_]) {
+            case 'n':
+                parse_literal(slot, "null", Null);
+                break;
+            case 't':
+                parse_literal(slot, "true", True);
+                break;
+            case 'f':
+                parse_literal(slot, "false", False);
+                break;
+            case '"':
+                parse_string(slot);
+                break;
+            case '[':
+                parse_array(slot);
+                break;
+            case '{':
+                parse_object(slot);
+                break;
+            default:
+                parse_number(slot);
+                break;
+            }
+        }
+
+        constexpr auto parse_literal(std::uint32_t    slot,
+                                     std::string_view literal,
+                                     StaticNode::Type type) -> void {
+            if (in_.substr(pos_, literal.length()) != literal) {
+                fail("invalid literal");
+                return;
+            }
+            pos_ += literal.length();
+            StaticNode node;
+            node.type_ = type;
+            set(slot, node);
+        }
+
+        // Decodes the string at `pos_` into the character table.
+        constexpr auto parse_string(std::uint32_t slot) -> void {
+            StaticNode node;
+            node.type_ = StaticNode::Type::String;
+            node.offset_ = static_cast<std::uint32_t>(char_count_);
+            const auto *first = in_.data() + pos_ + 1;
+            const auto *last = in_.data() + in_.length();
+            const auto *p = first;
+            while (true) {
+                pos_ = static_cast<std::size_t>(p - in_.data());
+                if (p == last) {
+                    fail("unterminated string");
+                    return;
+                }
+                if (*p == '"') {
+                    break;
+                }
+                if (static_cast<unsigned char>(*p) < 0x20) {
+                    fail("unescaped control character in a string");
+                    return;
+                }
+                if (*p != '\\') {
+                    put(*p++);
+                    continue;
+                }
+                if (last - p < 2
+                    || (p[1] != 'u' ? json_unescape(p[1]) == '\0'
+                                    : parse_hex4(p + 2, last) < 0)) {
+                    fail("invalid escape sequence");
+                    return;
+                }
+                char  decoded[4]{};
+                char *end = decoded;
+                p = json_unescape_to(p, last, end);
+                for (const auto *c = decoded; c != end; ++c) {
+                    put(*c);
+                }
+            }
+            if (simd::find_invalid_utf8(first, p) != p) {
+                pos_ = static_cast<std::size_t>(
+                    simd::find_invalid_utf8(first, p) - in_.data());
+                fail("invalid UTF-8");
+                return;
+            }
+            pos_++;
+            node.size_ = static_cast<std::uint32_t>(char_count_) - node.offset_;
+            set(slot, node);
+        }
+
+        constexpr auto parse_number(std::uint32_t slot) -> void {
+            auto start = pos_;
+            if (!skip_number(in_, pos_)) {
+                pos_ = start;
+                fail(in_[pos_] == '-' || ('0' <= in_[pos_] && in_[pos_] <= '9')
+                         ? "invalid number"
+                         : "unexpected character");
+                return;
+            }
+            // the first pass only counts nodes
+            if (building()) {
+                set(slot, convert_number(in_.substr(start, pos_ - start)));
+            }
+        }
+
+        // Integers that fit 64 bits are exact. Other numbers are converted
+        // with one correctly rounded operation when their significand fits a
+        // double and the power of ten does too (Clinger's fast path), and
+        // with big integers otherwise; both round to nearest, ties to even,
+        // like std::from_chars.
+        static constexpr auto convert_number(std::string_view text) noexcept
+            -> StaticNode {
+            using enum StaticNode::Type;
+            constexpr double powers[] = {
+                1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+            };
+            StaticNode  node;
+            std::size_t i = 0;
+            bool        negative = text[0] == '-';
+            i += negative ? 1 : 0;
+
+            std::uint64_t significand = 0;
+            int           digits = 0;
+            int           exponent = 0;
+            bool          integer = true;
+            auto          add_digit = [&](char c) {
+                // leading zeros are not significant
+                if (significand == 0 && c == '0') {
+                    return;
+                }
+                if (digits < 19) {
+                    significand = significand * 10 + (c - '0');
+                } else {
+                    exponent++;
+                }
+                digits++;
+            };
+            for (; i < text.length() && '0' <= text[i] && text[i] <= '9'; i++) {
+                add_digit(text[i]);
+            }
+            if (i < text.length() && text[i] == '.') {
+                integer = false;
+                for (i++; i < text.length() && '0' <= text[i] && text[i] <= '9';
+                     i++) {
+                    add_digit(text[i]);
+                    exponent--;
+                }
+            }
+            if (i < text.length()) {
+                integer = false;
+                bool negative_exponent = text[++i] == '-';
+                i += text[i] == '-' || text[i] == '+' ? 1 : 0;
+                int written = 0;
+                for (; i < text.length(); i++) {
+                    written = written < 10000 ? written * 10 + (text[i] - '0')
+                                              : written;
+                }
+                exponent += negative_exponent ? -written : written;
+            }
+
+            if (integer) {
+                // Exact, unless it needs more than 64 bits.
+                constexpr auto uint64_max
+                    = std::numeric_limits<std::uint64_t>::max();
+                std::uint64_t value = 0;
+                bool          fits = true;
+                for (auto c : text.substr(negative ? 1 : 0)) {
+                    auto digit = static_cast<std::uint64_t>(c - '0');
+                    fits = fits && value <= (uint64_max - digit) / 10;
+                    value = value * 10 + digit;
+                }
+                constexpr auto int64_max = static_cast<std::uint64_t>(
+                    std::numeric_limits<std::int64_t>::max());
+                if (fits && !negative && value > int64_max) {
+                    node.type_ = UInt64;
+                    node.uint64_ = value;
+                    return node;
+                }
+                if (fits && value <= int64_max + (negative ? 1 : 0)) {
+                    node.type_ = Int64;
+                    node.int64_ = negative
+                                      ? static_cast<std::int64_t>(0 - value)
+                                      : static_cast<std::int64_t>(value);
+                    return node;
+                }
+            }
+
+            node.type_ = Double;
+            if (significand == 0) {
+                node.double_ = negative ? -0.0 : 0.0;
+            } else if (digits <= 19 && significand <= (std::uint64_t{1} << 53)
+                       && -22 <= exponent && exponent <= 22) {
+                auto value = static_cast<double>(significand);
+                value = exponent < 0 ? value / powers[-exponent]
+                                     : value * powers[exponent];
+                node.double_ = negative ? -value : value;
+            } else {
+                auto value = exact_double(text.substr(negative ? 1 : 0));
+                node.double_ = negative ? -value : value;
+            }
+            return node;
+        }
+
+        // The double nearest to the unsigned number `text`. Its significant
+        // digits M and decimal exponent E give M * 5^E * 2^E, where 5^E is a
+        // big integer factor or divisor. The quotient is scaled by a power of
+        // two so that its integer part has 55 or 56 bits; those bits and
+        // whether a remainder is left decide rounding.
+        static constexpr auto exact_double(std::string_view text) -> double {
+            // Halfway points between doubles have at most 767 significant
+            // digits; past `max_digits`, a nonzero digit only matters as
+            // being more than nothing, which one more digit 1 stands for.
+            constexpr int max_digits = 800;
+            StaticBigInt  numerator;
+            int           digits = 0;
+            int           exponent = 0;
+            bool          fraction = false;
+            bool          dropped = false;
+            // digits not yet added to `numerator`, nine at most
+            std::uint32_t pending = 0;
+            std::uint32_t pending_scale = 1;
+            std::size_t   i = 0;
+            for (; i < text.length() && text[i] != 'e' && text[i] != 'E'; i++) {
+                if (text[i] == '.') {
+                    fraction = true;
+                } else if (digits == max_digits) {
+                    dropped = dropped || text[i] != '0';
+                    exponent += fraction ? 0 : 1;
+                } else {
+                    // leading zeros are not significant
+                    if (digits > 0 || text[i] != '0') {
+                        pending = pending * 10
+                                  + static_cast<std::uint32_t>(text[i] - '0');
+                        pending_scale *= 10;
+                        digits++;
+                    }
+                    if (pending_scale == 1'000'000'000) {
+                        numerator.multiply_add(pending_scale, pending);
+                        pending = 0;
+                        pending_scale = 1;
+                    }
+                    exponent -= fraction ? 1 : 0;
+                }
+            }
+            numerator.multiply_add(pending_scale, pending);
+            if (dropped) {
+                numerator.multiply_add(10, 1);
+                digits++;
+                exponent--;
+            }
+            if (i < text.length()) {
+                bool negative_exponent = text[++i] == '-';
+                i += text[i] == '-' || text[i] == '+' ? 1 : 0;
+                int written = 0;
+                for (; i < text.length(); i++) {
+                    written = written < 10000 ? written * 10 + (text[i] - '0')
+                                              : written;
+                }
+                exponent += negative_exponent ? -written : written;
+            }
+            // The value lies in [10^(digits + exponent - 1), 10^(digits +
+            // exponent)), so these bounds need no big integers at all.
+            if (digits + exponent > 310) {
+                return std::numeric_limits<double>::infinity();
+            }
+            if (digits + exponent < -324) {
+                return 0.0;
+            }
+
+            StaticBigInt denominator{1};
+            numerator.multiply_pow5(exponent > 0 ? exponent : 0);
+            denominator.multiply_pow5(exponent < 0 ? -exponent : 0);
+            auto scale = static_cast<int>(denominator.bit_width())
+                         - static_cast<int>(numerator.bit_width()) + 55;
+            if (scale > 0) {
+                numerator.shift_left(static_cast<std::size_t>(scale));
+            } else {
+                denominator.shift_left(static_cast<std::size_t>(-scale));
+            }
+            // long division, one bit at a time
+            std::uint64_t quotient = 0;
+            denominator.shift_left(55);
+            for (int bit = 55; bit >= 0; bit--) {
+                if (!(numerator < denominator)) {
+                    numerator.subtract(denominator);
+                    quotient |= std::uint64_t{1} << bit;
+                }
+                denominator.shift_right_one();
+            }
+            bool inexact = !numerator.is_zero();
+
+            // value = (quotient + inexact part) * 2^binary; keep 53 bits, or
+            // fewer where the result is subnormal
+            auto binary = exponent - scale;
+            auto width = static_cast<int>(std::bit_width(quotient));
+            auto shift
+                = width - 1 + binary >= -1022 ? width - 53 : -1074 - binary;
+            if (shift > width) {
+                return 0.0;
+            }
+            auto mantissa = quotient >> shift;
+            auto rest = quotient & ((std::uint64_t{1} << shift) - 1);
+            auto half = std::uint64_t{1} << (shift - 1);
+            if (rest > half || (rest == half && (inexact || (mantissa & 1)))) {
+                mantissa++;
+            }
+            auto lowest = shift + binary;
+            if (mantissa == std::uint64_t{1} << 53) {
+                mantissa >>= 1;
+                lowest++;
+            }
+            constexpr auto fraction_mask = (std::uint64_t{1} << 52) - 1;
+            if (mantissa <= fraction_mask) {
+                // subnormal, `lowest` is -1074
+                return std::bit_cast<double>(mantissa);
+            }
+            auto biased = lowest + 52 + 1023;
+            if (biased >= 2047) {
+                return std::numeric_limits<double>::infinity();
+            }
+            return std::bit_cast<double>(
+                (static_cast<std::uint64_t>(biased) << 52)
+                | (mantissa & fraction_mask));
+        }
+
+        constexpr auto parse_array(std::uint32_t slot) -> void {
+            auto          ordinal = containers_++;
+            std::uint32_t count = 0;
+            std::uint32_t first = 0;
+            if (building()) {
+                first = allocate((*counts_)[ordinal]);
+            } else {
+                counts_->push_back(0);
+            }
+            pos_++;
+            if (!consume(']')) {
+                do {
+                    parse_value(building() ? first + count : allocate(1));
+                    count++;
+                } while (consume(','));
+                if (pos_ == in_.length() || in_[pos_] != ']') {
+                    fail("expected ',' or ']'");
+                    return;
+                }
+                pos_++;
+            }
+            (*counts_)[ordinal] = count;
+            StaticNode node;
+            node.type_ = StaticNode::Type::Array;
+            node.size_ = count;
+            node.offset_ = first;
+            set(slot, node);
+        }
+
+        constexpr auto parse_object(std::uint32_t slot) -> void {
+            auto          ordinal = containers_++;
+            std::uint32_t count = 0;
+            std::uint32_t first = 0;
+            if (building()) {
+                first = allocate(2 * (*counts_)[ordinal]);
+            } else {
+                counts_->push_back(0);
+            }
+            pos_++;
+            if (!consume('}')) {
+                do {
+                    auto key = building() ? first + 2 * count : allocate(2);
+                    skip_whitespace();
+                    if (pos_ == in_.length() || in_[pos_] != '"') {
+                        fail("expected a key");
+                        return;
+                    }
+                    parse_string(key);
+                    if (!consume(':')) {
+                        fail("expected ':'");
+                        return;
+                    }
+                    parse_value(key + 1);
+                    count++;
+                } while (consume(','));
+                if (pos_ == in_.length() || in_[pos_] != '}') {
+                    fail("expected ',' or '}'");
+                    return;
+                }
+                pos_++;
+            }
+            (*counts_)[ordinal] = count;
+            StaticNode node;
+            node.type_ = StaticNode::Type::Object;
+            node.size_ = count;
+            node.offset_ = first;
+            set(slot, node);
+        }
+
+        std::string_view            in_;
+        std::size_t                 pos_{0};
+        std::vector<std::uint32_t> *counts_;
+        StaticNode                 *nodes_;
+        char                       *chars_;
+        std::uint32_t               node_count_{0};
+        std::size_t                 char_count_{0};
+        std::size_t                 containers_{0};
+    };
+
+    template <FixedString Text>
+    consteval auto make_static_json() {
+        constexpr auto size = StaticParser::measure(Text.view());
+        StaticDocument<size.nodes_, size.chars_> document;
+        StaticParser::build(
+            Text.view(), document.nodes_.data(), document.chars_.data());
+        return document;
+    }
+} // namespace detail
+
+// The parsed form of the literal `Text`, one instance per distinct literal.
+template <FixedString Text>
+inline constexpr auto static_json = detail::make_static_json<Text>();
+
+} // namespace jsonlib
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/parse_error.hpp"
+#include "jsonlib/simd.hpp"
+
+namespace jsonlib {
+
+// Resumable parser for input that arrives in pieces. Chunks may split the
+// document anywhere, including inside strings, numbers and literals. The
+// parser keeps the partially built tree, one frame per open container and
+// the bytes of at most one unfinished token; complete tokens are converted
+// straight from the chunk by the regular parser. Malformed input stops the
+// parser for good; `error()` then says why and where. Of the ParseOptions
+// only `max_depth` applies: tokens are copied, so nothing can be borrowed.
+template <typename Allocator>
+class BasicStreamParser {
+public:
+    using json_t = BasicJson<Allocator>;
+
+    explicit BasicStreamParser(const Allocator &alloc = Allocator())
+        : BasicStreamParser(ParseOptions{}, alloc) {}
+
+    explicit BasicStreamParser(const ParseOptions &options,
+                               const Allocator    &alloc = Allocator())
+        : alloc_{alloc}
+        , result_{alloc}
+        , max_depth_{options.max_depth} {}
+
+    // Parses the next chunk. Returns true once a complete document has been
+    // seen; only whitespace may follow it. Once the input has been rejected,
+    // returns false and ignores further chunks.
+    auto feed(std::string_view chunk) -> bool {
+        if (failed()) [[unlikely]] {
+            return false;
+        }
+        std::size_t pos = 0;
+        if (mode_ != Mode::None) {
+            pos = continue_token(chunk);
+        }
+        while (pos < chunk.size() && !failed()) {
+            pos = static_cast<std::size_t>(
+                simd::skip_whitespace(chunk.data() + pos,
+                                      chunk.data() + chunk.size())
+                - chunk.data());
+            if (pos == chunk.size()) {
+                break;
+            }
+            if (done_) [[unlikely]] {
+                fail(ParseError::Kind::TrailingCharacters, offset_ + pos);
+                break;
+            }
+            pos = step(chunk, pos);
+        }
+        offset_ += chunk.size();
+        return done_;
+    }
+
+    // Marks the end of the input. A top-level number can only be completed
+    // here, since more digits could have followed. Returns false if the
+    // document is malformed or incomplete.
+    auto finish() -> bool {
+        if (mode_ == Mode::Bare) {
+            mode_ = Mode::None;
+            complete(token_);
+            token_.clear();
+        } else if (mode_ == Mode::String) {
+            fail(ParseError::Kind::UnterminatedString, token_start_);
+        }
+        if (!done_ && !failed()) {
+            fail(ParseError::Kind::UnexpectedEnd, offset_);
+        }
+        return done_;
+    }
+
+    auto done() const noexcept -> bool {
+        return done_;
+    }
+
+    auto failed() const noexcept -> bool {
+        return error_.kind != ParseError::Kind::None;
+    }
+
+    // Why and where the input was rejected. The offset counts from the start
+    // of the first chunk; line and column are not tracked.
+    auto error() const noexcept -> const ParseError & {
+        return error_;
+    }
+
+    // The parsed document, once `done()`.
+    auto release() -> json_t {
+        ASSERT(done_);
+        return std::move(result_);
+    }
+
+private:
+    enum class Mode : std::uint8_t {
+        None,
+        String,
+        // number or literal
+        Bare,
+    };
+
+    enum class Expect : std::uint8_t {
+        FirstValue,
+        Value,
+        FirstKey,
+        Key,
+        Colon,
+        Comma,
+    };
+
+    struct Frame {
+        json_t      value_;
+        std::string key_;
+        Expect      expect_;
+        bool        object_;
+    };
+
+    // Malformed input at `offset`, counted from the start of the stream:
+    // keeps the first error and drops the partial document.
+    [[gnu::cold]] auto fail(ParseError::Kind kind, std::size_t offset)
+        -> void {
+        if (!failed()) {
+            error_ = {kind, offset};
+        }
+        mode_ = Mode::None;
+        escape_pending_ = false;
+        done_ = false;
+        token_.clear();
+        stack_.clear();
+    }
+
+    // Consumes the structural character or starts the token at `pos`.
+    auto step(std::string_view chunk, std::size_t pos) -> std::size_t {
+        using enum ParseError::Kind;
+        auto   c = chunk[pos];
+        auto   expect = stack_.empty() ? Expect::Value : stack_.back().expect_;
+        Frame *top = stack_.empty() ? nullptr : &stack_.back();
+        switch (expect) {
+        case Expect::Colon:
+            if (c != ':') [[unlikely]] {
+                fail(ExpectedColon, offset_ + pos);
+                return pos;
+            }
+            top->expect_ = Expect::Value;
+            return pos + 1;
+        case Expect::Comma:
+            if (c == ',') {
+                top->expect_ = top->object_ ? Expect::Key : Expect::Value;
+                return pos + 1;
+            }
+            if (c != (top->object_ ? '}' : ']')) [[unlikely]] {
+                fail(top->object_ ? ExpectedCommaOrBrace
+                                  : ExpectedCommaOrBracket,
+                     offset_ + pos);
+                return pos;
+            }
+            close();
+            return pos + 1;
+        case Expect::FirstKey:
+            if (c == '}') {
+                close();
+                return pos + 1;
+            }
+            [[fallthrough]];
+        case Expect::Key:
+            if (c != '"') [[unlikely]] {
+                fail(ExpectedKey, offset_ + pos);
+                return pos;
+            }
+            return start_token(chunk, pos);
+        case Expect::FirstValue:
+            if (c == ']') {
+                close();
+                return pos + 1;
+            }
+            [[fallthrough]];
+        case Expect::Value:
+            if (c == '{' || c == '[') {
+                if (stack_.size() == max_depth_) [[unlikely]] {
+                    fail(TooDeep, offset_ + pos);
+                    return pos;
+                }
+                open(c == '{');
+                return pos + 1;
+            }
+            if (c != '"' && !is_bare(c)) [[unlikely]] {
+                fail(UnexpectedCharacter, offset_ + pos);
+                return pos;
+            }
+            return start_token(chunk, pos);
+        }
+        return pos + 1;
+    }
+
+    auto open(bool object) -> void {
+        Frame frame{json_t{alloc_},
+                    {},
+                    object ? Expect::FirstKey : Expect::FirstValue,
+                    object};
+        if (object) {
+            frame.value_.value_.template to<json_t::Object>();
+        } else {
+            frame.value_.value_.template to<json_t::Array>();
+        }
+        stack_.push_back(std::move(frame));
+    }
+
+    auto close() -> void {
+        auto value = std::move(stack_.back().value_);
+        stack_.pop_back();
+        emit(std::move(value));
+    }
+
+    // Tokens that end inside `chunk` are converted in place; otherwise
+    // their first part is kept until the next chunk.
+    auto start_token(std::string_view chunk, std::size_t pos) -> std::size_t {
+        auto start = pos;
+        token_start_ = offset_ + pos;
+        if (chunk[pos] == '"') {
+            mode_ = Mode::String;
+            pos = scan_string(chunk, pos + 1);
+        } else {
+            mode_ = Mode::Bare;
+            pos = scan_bare(chunk, pos);
+        }
+        if (mode_ == Mode::None) {
+            complete(chunk.substr(start, pos - start));
+        } else {
+            token_.assign(chunk.substr(start));
+        }
+        return pos;
+    }
+
+    auto continue_token(std::string_view chunk) -> std::size_t {
+        auto pos = mode_ == Mode::String ? scan_string(chunk, 0)
+                                         : scan_bare(chunk, 0);
+        token_.append(chunk.substr(0, pos));
+        if (mode_ == Mode::None) {
+            complete(token_);
+            token_.clear();
+        }
+        return pos;
+    }
+
+    // Returns the position after the closing quote, or the chunk size if the
+    // string continues into the next chunk.
+    auto scan_string(std::string_view chunk, std::size_t pos) -> std::size_t {
+        const auto *last = chunk.data() + chunk.size();
+        while (true) {
+            if (escape_pending_) {
+                if (pos == chunk.size()) {
+                    return pos;
+                }
+                pos++;
+                escape_pending_ = false;
+            }
+            const auto *special
+                = simd::find_quote_or_backslash(chunk.data() + pos, last);
+            if (special == last) {
+                return chunk.size();
+            }
+            pos = static_cast<std::size_t>(special - chunk.data()) + 1;
+            if (*special == '"') {
+                mode_ = Mode::None;
+                return pos;
+            }
+            escape_pending_ = true;
+        }
+    }
+
+    auto scan_bare(std::string_view chunk, std::size_t pos) -> std::size_t {
+        while (pos < chunk.size() && is_bare(chunk[pos])) {
+            pos++;
+        }
+        if (pos < chunk.size()) {
+            mode_ = Mode::None;
+        }
+        return pos;
+    }
+
+    static auto is_bare(char c) noexcept -> bool {
+        return ('0' <= c && c <= '9') || ('a' <= c && c <= 'z')
+               || ('A' <= c && c <= 'Z') || c == '-' || c == '+' || c == '.';
+    }
+
+    // Converts a whole token; it must be exactly one value, so "1.5.5" and
+    // "truex" are rejected rather than cut short.
+    auto complete(std::string_view token) -> void {
+        using enum ParseError::Kind;
+        ParseError  error;
+        std::size_t pos = 0;
+        auto        value
+            = json_t::Value::deserialize_from(token, pos, {alloc_, {}, &error});
+        if (error.kind == None && pos != token.size()) [[unlikely]] {
+            auto number
+                = token[0] == '-' || ('0' <= token[0] && token[0] <= '9');
+            error = {number ? InvalidNumber : InvalidLiteral, pos};
+        }
+        if (error.kind != None) [[unlikely]] {
+            fail(error.kind, token_start_ + error.offset);
+            return;
+        }
+        if (!stack_.empty()
+            && (stack_.back().expect_ == Expect::FirstKey
+                || stack_.back().expect_ == Expect::Key)) {
+            stack_.back().key_.assign(value.string());
+            stack_.back().expect_ = Expect::Colon;
+            return;
+        }
+        emit(std::move(value));
+    }
+
+    auto emit(json_t value) -> void {
+        if (stack_.empty()) {
+            result_ = std::move(value);
+            done_ = true;
+            return;
+        }
+        auto &top = stack_.back();
+        if (top.object_) {
+            top.value_.value_.template as<json_t::Object>().insert_or_assign(
+                typename json_t::string_t{top.key_, alloc_}, std::move(value));
+        } else {
+            top.value_.value_.template as<json_t::Array>().push_back(
+                std::move(value));
+        }
+        top.expect_ = Expect::Comma;
+    }
+
+    Allocator          alloc_;
+    json_t             result_;
+    std::vector<Frame> stack_;
+    std::size_t        max_depth_;
+    std::string        token_;
+    // where the current token starts, and the current chunk
+    std::size_t        token_start_{0};
+    std::size_t        offset_{0};
+    ParseError         error_;
+    Mode               mode_{Mode::None};
+    bool               escape_pending_{false};
+    bool               done_{false};
+};
+
+using StreamParser = BasicStreamParser<std::allocator<char>>;
+
+} // namespace jsonlib
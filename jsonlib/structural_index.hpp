@@ -0,0 +1,312 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/simd.hpp"
+
+namespace jsonlib {
+
+// Stage 1 of two-stage parsing: the positions of every structural character
+// of a document, in order. These are `{}[]:,` outside of strings, the opening
+// quote of every string and the first character of every number or literal.
+// The input is classified 64 bytes at a time into bitmasks, so quotes,
+// escapes and strings are resolved without branching per character.
+class StructuralIndex {
+public:
+    static auto build(std::string_view in) -> StructuralIndex;
+
+    auto positions() const noexcept -> const std::vector<std::uint32_t> & {
+        return positions_;
+    }
+
+    auto size() const noexcept -> std::size_t {
+        return positions_.size();
+    }
+
+    // False if a string was still open at the end of the input.
+    auto strings_closed() const noexcept -> bool {
+        return strings_closed_;
+    }
+
+    // True if the input was 4 GiB or more, beyond what 32-bit positions can
+    // address; nothing is indexed then.
+    auto too_large() const noexcept -> bool {
+        return too_large_;
+    }
+
+private:
+    std::vector<std::uint32_t> positions_;
+    bool                       strings_closed_{true};
+    bool                       too_large_{false};
+};
+
+namespace detail {
+    // Character classes of one 64-byte block, one bit per byte.
+    struct BlockMasks {
+        std::uint64_t backslash_;
+        std::uint64_t quote_;
+        std::uint64_t whitespace_;
+        // {}[]:,
+        std::uint64_t op_;
+    };
+
+    inline auto block_masks_scalar(const char *block) noexcept -> BlockMasks {
+        BlockMasks masks{};
+        for (int i = 0; i < 64; i++) {
+            auto bit = std::uint64_t{1} << i;
+            switch (block[i]) {
+            case '\\':
+                masks.backslash_ |= bit;
+                break;
+            case '"':
+                masks.quote_ |= bit;
+                break;
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                masks.whitespace_ |= bit;
+                break;
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+                masks.op_ |= bit;
+                break;
+            default:
+                break;
+            }
+        }
+        return masks;
+    }
+
+#if JSONLIB_SIMD_X86
+    // Lambdas do not inherit a target attribute, so the per-register
+    // classification is spelled out as functions.
+    __attribute__((target("sse2"))) inline auto
+    block_masks_sse2_part(__m128i chunk, BlockMasks &masks, int shift) noexcept
+        -> void {
+        auto bits = [](int movemask) {
+            return static_cast<std::uint64_t>(static_cast<unsigned>(movemask));
+        };
+        auto eq = [](__m128i x, char c) {
+            return _mm_cmpeq_epi8(x, _mm_set1_epi8(c));
+        };
+        auto backslash = eq(chunk, '\\');
+        auto quote = eq(chunk, '"');
+        auto whitespace
+            = _mm_or_si128(_mm_or_si128(eq(chunk, ' '), eq(chunk, '\n')),
+                           _mm_or_si128(eq(chunk, '\r'), eq(chunk, '\t')));
+        // '[' | 0x20 == '{' and ']' | 0x20 == '}'.
+        auto lower = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+        auto op = _mm_or_si128(_mm_or_si128(eq(lower, '{'), eq(lower, '}')),
+                               _mm_or_si128(eq(chunk, ':'), eq(chunk, ',')));
+        masks.backslash_ |= bits(_mm_movemask_epi8(backslash)) << shift;
+        masks.quote_ |= bits(_mm_movemask_epi8(quote)) << shift;
+        masks.whitespace_ |= bits(_mm_movemask_epi8(whitespace)) << shift;
+        masks.op_ |= bits(_mm_movemask_epi8(op)) << shift;
+    }
+
+    __attribute__((target("sse2"))) inline auto
+    block_masks_sse2(const char *block) noexcept -> BlockMasks {
+        BlockMasks masks{};
+        for (int i = 0; i < 4; i++) {
+            block_masks_sse2_part(_mm_loadu_si128(
+                                      reinterpret_cast<const __m128i *>(
+                                          block + i * 16)),
+                                  masks,
+                                  i * 16);
+        }
+        return masks;
+    }
+
+    __attribute__((target("avx2"))) inline auto
+    block_masks_avx2_part(__m256i chunk, BlockMasks &masks, int shift) noexcept
+        -> void {
+        auto bits = [](int movemask) {
+            return static_cast<std::uint64_t>(static_cast<unsigned>(movemask));
+        };
+        auto backslash = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'));
+        auto quote = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'));
+        auto whitespace = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')),
+                            _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r')),
+                            _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))));
+        auto lower = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+        auto op = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{')),
+                            _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':')),
+                            _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(','))));
+        masks.backslash_ |= bits(_mm256_movemask_epi8(backslash)) << shift;
+        masks.quote_ |= bits(_mm256_movemask_epi8(quote)) << shift;
+        masks.whitespace_ |= bits(_mm256_movemask_epi8(whitespace)) << shift;
+        masks.op_ |= bits(_mm256_movemask_epi8(op)) << shift;
+    }
+
+    __attribute__((target("avx2"))) inline auto
+    block_masks_avx2(const char *block) noexcept -> BlockMasks {
+        BlockMasks masks{};
+        for (int i = 0; i < 2; i++) {
+            block_masks_avx2_part(_mm256_loadu_si256(
+                                      reinterpret_cast<const __m256i *>(
+                                          block + i * 32)),
+                                  masks,
+                                  i * 32);
+        }
+        return masks;
+    }
+#endif
+
+    // Bit i of the result is the xor of bits 0..i of `x`.
+    constexpr auto prefix_xor(std::uint64_t x) noexcept -> std::uint64_t {
+        x ^= x << 1;
+        x ^= x << 2;
+        x ^= x << 4;
+        x ^= x << 8;
+        x ^= x << 16;
+        x ^= x << 32;
+        return x;
+    }
+
+    // State carried from one block to the next.
+    struct Stage1State {
+        std::uint64_t next_is_escaped_{0};
+        // all ones while inside a string
+        std::uint64_t in_string_{0};
+        std::uint64_t follows_scalar_{0};
+    };
+
+    // Structural bits of one block (see StructuralIndex).
+    [[gnu::always_inline]] inline auto
+    structural_bits(const BlockMasks &masks, Stage1State &state) noexcept
+        -> std::uint64_t {
+        // A character is escaped when it follows an odd-length run of
+        // backslashes. Runs are told apart by the parity of their start
+        // position: adding a run to its start bit carries to the bit after
+        // it, and the odd/even pattern flips for runs of odd length.
+        constexpr std::uint64_t odd_bits = 0xaaaa'aaaa'aaaa'aaaaULL;
+        std::uint64_t           escaped = state.next_is_escaped_;
+        if (masks.backslash_ == 0) {
+            state.next_is_escaped_ = 0;
+        } else {
+            auto potential = masks.backslash_ & ~state.next_is_escaped_;
+            auto escape_and_terminal
+                = (((potential << 1) | odd_bits) - potential) ^ odd_bits;
+            escaped = escape_and_terminal
+                      ^ (masks.backslash_ | state.next_is_escaped_);
+            state.next_is_escaped_
+                = (escape_and_terminal & masks.backslash_) >> 63;
+        }
+
+        // Strings span from an opening quote up to (not including) the
+        // closing one; `string_tail` is everything but the opening quote.
+        auto quote = masks.quote_ & ~escaped;
+        auto in_string = prefix_xor(quote) ^ state.in_string_;
+        state.in_string_ = static_cast<std::uint64_t>(
+            static_cast<std::int64_t>(in_string) >> 63);
+        auto string_tail = in_string ^ quote;
+
+        // Numbers and literals start at a non-whitespace, non-operator
+        // character that does not follow another one.
+        auto scalar = ~(masks.op_ | masks.whitespace_);
+        auto nonquote_scalar = scalar & ~quote;
+        auto follows_scalar = (nonquote_scalar << 1) | state.follows_scalar_;
+        state.follows_scalar_ = nonquote_scalar >> 63;
+        auto scalar_start = scalar & ~follows_scalar;
+
+        return (masks.op_ | quote | scalar_start) & ~string_tail;
+    }
+
+    template <auto Masks>
+    [[gnu::always_inline]] inline auto
+    build_index(std::string_view in, std::vector<std::uint32_t> &positions)
+        -> bool {
+        Stage1State state;
+        std::size_t count = 0;
+        auto        flatten = [&](std::uint64_t bits, std::size_t base) {
+            if (positions.size() < count + 64) {
+                positions.resize(std::max(positions.size() * 2, count + 64));
+            }
+            auto *out = positions.data() + count;
+            count += static_cast<std::size_t>(std::popcount(bits));
+            while (bits != 0) {
+                *out++ = static_cast<std::uint32_t>(
+                    base + static_cast<std::size_t>(std::countr_zero(bits)));
+                bits &= bits - 1;
+            }
+        };
+
+        std::size_t base = 0;
+        for (; base + 64 <= in.size(); base += 64) {
+            flatten(structural_bits(Masks(in.data() + base), state), base);
+        }
+        if (base < in.size()) {
+            // The tail is padded with whitespace, which is never structural.
+            char block[64];
+            std::memset(block, ' ', sizeof(block));
+            std::memcpy(block, in.data() + base, in.size() - base);
+            flatten(structural_bits(Masks(block), state), base);
+        }
+        positions.resize(count);
+        return state.in_string_ == 0;
+    }
+
+    using build_index_fn = auto (*)(std::string_view,
+                                    std::vector<std::uint32_t> &) -> bool;
+
+    inline auto build_index_scalar(std::string_view            in,
+                                   std::vector<std::uint32_t> &positions)
+        -> bool {
+        return build_index<block_masks_scalar>(in, positions);
+    }
+
+#if JSONLIB_SIMD_X86
+    __attribute__((target("sse2"))) inline auto
+    build_index_sse2(std::string_view in, std::vector<std::uint32_t> &positions)
+        -> bool {
+        return build_index<block_masks_sse2>(in, positions);
+    }
+
+    __attribute__((target("avx2"))) inline auto
+    build_index_avx2(std::string_view in, std::vector<std::uint32_t> &positions)
+        -> bool {
+        return build_index<block_masks_avx2>(in, positions);
+    }
+#endif
+
+    inline auto select_build_index() noexcept -> build_index_fn {
+#if JSONLIB_SIMD_X86
+        if (simd::detail::has_avx2()) {
+            return build_index_avx2;
+        }
+        return build_index_sse2;
+#else
+        return build_index_scalar;
+#endif
+    }
+} // namespace detail
+
+inline auto StructuralIndex::build(std::string_view in) -> StructuralIndex {
+    static const detail::build_index_fn impl = detail::select_build_index();
+    StructuralIndex index;
+    if (in.size() >= std::numeric_limits<std::uint32_t>::max()) [[unlikely]] {
+        index.too_large_ = true;
+        return index;
+    }
+    index.strings_closed_ = impl(in, index.positions_);
+    return index;
+}
+
+} // namespace jsonlib
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <system_error>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/json_codec.hpp"
+#include "jsonlib/simd.hpp"
+
+// Token-level scanning shared by the DOM parser (BasicJson::deserialize) and
+// the event parser (parse_events). Positions are indices into `in`.
+namespace jsonlib::detail {
+
+inline auto eat_whitespace(std::string_view in, std::size_t &pos) -> void {
+    auto *end = in.data() + in.length();
+    pos = static_cast<std::size_t>(
+        simd::skip_whitespace(in.data() + pos, end) - in.data());
+}
+
+// Skips whitespace, then consumes `c` if it comes next.
+inline auto consume(std::string_view in, std::size_t &pos, char c) -> bool {
+    eat_whitespace(in, pos);
+    if (pos < in.length() && in[pos] == c) {
+        pos++;
+        return true;
+    }
+    return false;
+}
+
+// Consumes `literal` if it comes next; malformed input is left to the caller
+// to report, here and below.
+inline auto expect_literal(std::string_view in,
+                           std::size_t     &pos,
+                           std::string_view literal) -> bool {
+    if (in.substr(pos, literal.length()) != literal) [[unlikely]] {
+        return false;
+    }
+    pos += literal.length();
+    return true;
+}
+
+// Length of the string body starting at `pos` (just past the opening quote)
+// if it contains no escape sequences, otherwise npos.
+inline auto plain_string_length(std::string_view in, std::size_t pos) noexcept
+    -> std::size_t {
+    const auto *first = in.data() + pos;
+    const auto *last = in.data() + in.length();
+    const auto *special = simd::find_quote_or_backslash(first, last);
+    if (special != last && *special == '"') {
+        return static_cast<std::size_t>(special - first);
+    }
+    return std::string_view::npos;
+}
+
+// Position after the closing quote of the string body starting at `pos`
+// (just past the opening quote), or npos if the string is not terminated.
+// Escapes are stepped over, not decoded.
+inline auto skip_string(std::string_view in, std::size_t pos) noexcept
+    -> std::size_t {
+    const auto *first = in.data() + pos;
+    const auto *last = in.data() + in.length();
+    while (true) {
+        const auto *special = simd::find_quote_or_backslash(first, last);
+        if (special != last && *special == '"') {
+            return static_cast<std::size_t>(special + 1 - in.data());
+        }
+        if (last - special < 2) [[unlikely]] {
+            return std::string_view::npos;
+        }
+        first = special + 2;
+    }
+}
+
+// Decodes the string body starting at `pos` (just past the opening quote)
+// into `out` in one pass: runs without quotes or backslashes are found a
+// block at a time and appended in bulk. Returns the position after the
+// closing quote, or npos if the string is not terminated.
+template <typename String>
+auto decode_string(std::string_view in, std::size_t pos, String &out)
+    -> std::size_t {
+    const auto *first = in.data() + pos;
+    const auto *last = in.data() + in.length();
+    while (true) {
+        const auto *special = simd::find_quote_or_backslash(first, last);
+        out.append(first, special);
+        if (special != last && *special == '"') {
+            return static_cast<std::size_t>(special + 1 - in.data());
+        }
+        if (last - special < 2) [[unlikely]] {
+            return std::string_view::npos;
+        }
+        // An escape decodes to at most four bytes.
+        char  decoded[4];
+        char *end = decoded;
+        first = json_unescape_to(special, last, end);
+        out.append(decoded, end);
+    }
+}
+
+// Whether a well-formed number too large or too small for a double is too
+// small, judged from the decimal exponent of its leading significant digit.
+inline auto underflows(const char *first, const char *last) noexcept -> bool {
+    long magnitude = 0;
+    bool point = false;
+    bool significant = false;
+    if (*first == '-') {
+        ++first;
+    }
+    for (; first != last && *first != 'e' && *first != 'E'; ++first) {
+        if (*first == '.') {
+            point = true;
+        } else if (*first != '0' || significant) {
+            significant = true;
+            magnitude += point ? 0 : 1;
+        } else if (point) {
+            magnitude--;
+        }
+    }
+    if (first == last) {
+        return magnitude <= 0;
+    }
+    ++first;
+    bool negative_exponent = *first == '-';
+    if (*first == '+' || *first == '-') {
+        ++first;
+    }
+    long exponent{};
+    if (std::from_chars(first, last, exponent).ec != std::errc{}) {
+        return negative_exponent;
+    }
+    return magnitude + (negative_exponent ? -exponent : exponent) <= 0;
+}
+
+// Skips a number that follows the JSON grammar exactly, which, unlike
+// parse_number, also rejects leading zeros ("01"). Returns false, with `pos`
+// somewhere inside the number, if there is none.
+constexpr auto skip_number(std::string_view in, std::size_t &pos) noexcept
+    -> bool {
+    auto length = in.length();
+    auto digit = [&] {
+        return pos < length && '0' <= in[pos] && in[pos] <= '9';
+    };
+    auto digits = [&] {
+        auto first = pos;
+        while (digit()) {
+            pos++;
+        }
+        return pos != first;
+    };
+
+    if (pos < length && in[pos] == '-') {
+        pos++;
+    }
+    if (pos < length && in[pos] == '0') {
+        pos++;
+        if (digit()) [[unlikely]] {
+            return false;
+        }
+    } else if (!digits()) [[unlikely]] {
+        return false;
+    }
+    if (pos < length && in[pos] == '.') {
+        pos++;
+        if (!digits()) [[unlikely]] {
+            return false;
+        }
+    }
+    if (pos < length && (in[pos] == 'e' || in[pos] == 'E')) {
+        pos++;
+        if (pos < length && (in[pos] == '+' || in[pos] == '-')) {
+            pos++;
+        }
+        if (!digits()) [[unlikely]] {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Number {
+    enum class Kind : std::uint8_t {
+        Int64,
+        UInt64,
+        Double,
+        // not a number per the JSON grammar
+        Invalid,
+    };
+
+    Kind kind_;
+    union {
+        std::int64_t  int64_;
+        std::uint64_t uint64_;
+        double        double_;
+    };
+};
+
+// Scans a number following the JSON grammar, then converts it with
+// std::from_chars without copying the digits. Integers become Int64 (or
+// UInt64 when they only fit unsigned); fractions, exponents and integers
+// beyond 64 bits become Double. Anything else is Invalid.
+inline auto parse_number(std::string_view in, std::size_t &pos) -> Number {
+    auto start = pos;
+    auto length = in.length();
+    auto digits = [&] {
+        auto first = pos;
+        while (pos < length && '0' <= in[pos] && in[pos] <= '9') {
+            pos++;
+        }
+        return pos - first;
+    };
+
+    bool negative = pos < length && in[pos] == '-';
+    if (negative) {
+        pos++;
+    }
+    Number number{};
+    number.kind_ = Number::Kind::Invalid;
+    if (digits() == 0) [[unlikely]] {
+        return number;
+    }
+    bool integer = true;
+    if (pos < length && in[pos] == '.') {
+        pos++;
+        if (digits() == 0) [[unlikely]] {
+            return number;
+        }
+        integer = false;
+    }
+    if (pos < length && (in[pos] == 'e' || in[pos] == 'E')) {
+        pos++;
+        if (pos < length && (in[pos] == '+' || in[pos] == '-')) {
+            pos++;
+        }
+        if (digits() == 0) [[unlikely]] {
+            return number;
+        }
+        integer = false;
+    }
+
+    const auto *first = in.data() + start;
+    const auto *last = in.data() + pos;
+    if (integer) {
+        if (negative) {
+            if (std::from_chars(first, last, number.int64_).ec
+                == std::errc{}) {
+                number.kind_ = Number::Kind::Int64;
+                return number;
+            }
+        } else if (std::from_chars(first, last, number.uint64_).ec
+                   == std::errc{}) {
+            number.kind_ = Number::Kind::UInt64;
+            if (number.uint64_ <= static_cast<std::uint64_t>(
+                    std::numeric_limits<std::int64_t>::max())) {
+                number.kind_ = Number::Kind::Int64;
+                number.int64_ = static_cast<std::int64_t>(number.uint64_);
+            }
+            return number;
+        }
+    }
+    // from_chars leaves `value` untouched when the result is out of range,
+    // so overflow and underflow are resolved here.
+    double value{};
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    if (ec == std::errc::result_out_of_range) {
+        value = underflows(first, last)
+                    ? 0.0
+                    : std::numeric_limits<double>::infinity();
+        value = negative ? -value : value;
+    } else {
+        ASSERT(ec == std::errc{} && ptr == last);
+    }
+    number.kind_ = Number::Kind::Double;
+    number.double_ = value;
+    return number;
+}
+
+} // namespace jsonlib::detail
@@ -0,0 +1,331 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "jsonlib/simd.hpp"
+
+// UTF-8 well-formedness (RFC 3629: no overlong forms, surrogates or code
+// points past U+10FFFF). The vector versions follow Keiser and Lemire,
+// "Validating UTF-8 In Less Than One Instruction Per Byte": every byte pair
+// is classified through three 16-entry nibble tables whose entries are
+// error bits, so a block is checked with three shuffles and an AND, and
+// pure ASCII blocks are skipped with one movemask.
+namespace jsonlib::simd {
+
+namespace detail {
+    // Returns the first byte of the first ill-formed sequence, or `last`.
+    // Also usable in constant expressions, hence no unsigned char pointers.
+    constexpr auto find_invalid_utf8_scalar(const char *first,
+                                            const char *last) noexcept
+        -> const char * {
+        auto byte = [](char c) {
+            return static_cast<unsigned char>(c);
+        };
+        const auto *p = first;
+        while (p != last) {
+            auto lead = byte(*p);
+            if (lead < 0x80) {
+                ++p;
+                continue;
+            }
+            std::size_t   length = 0;
+            unsigned char min = 0x80;
+            unsigned char max = 0xbf;
+            if (0xc2 <= lead && lead <= 0xdf) {
+                length = 2;
+            } else if (0xe0 <= lead && lead <= 0xef) {
+                length = 3;
+                // no overlong forms, no surrogates
+                min = lead == 0xe0 ? 0xa0 : 0x80;
+                max = lead == 0xed ? 0x9f : 0xbf;
+            } else if (0xf0 <= lead && lead <= 0xf4) {
+                length = 4;
+                // no overlong forms, nothing past U+10FFFF
+                min = lead == 0xf0 ? 0x90 : 0x80;
+                max = lead == 0xf4 ? 0x8f : 0xbf;
+            } else {
+                break;
+            }
+            if (static_cast<std::size_t>(last - p) < length
+                || byte(p[1]) < min || byte(p[1]) > max) {
+                break;
+            }
+            std::size_t i = 2;
+            while (i < length && (byte(p[i]) & 0xc0) == 0x80) {
+                i++;
+            }
+            if (i != length) {
+                break;
+            }
+            p += length;
+        }
+        return p;
+    }
+
+    using validate_fn = auto (*)(const char *first, const char *last) noexcept
+        -> bool;
+
+    inline auto is_valid_utf8_scalar(const char *first,
+                                     const char *last) noexcept -> bool {
+        return find_invalid_utf8_scalar(first, last) == last;
+    }
+
+#if JSONLIB_SIMD_X86
+    // Error bits. The tables below are indexed by the high nibble of the
+    // first byte of a pair, its low nibble and the high nibble of the
+    // second; a pair is invalid when one bit is set in all three.
+    constexpr std::uint8_t too_short = 1 << 0;
+    constexpr std::uint8_t too_long = 1 << 1;
+    constexpr std::uint8_t overlong_3 = 1 << 2;
+    constexpr std::uint8_t too_large = 1 << 3;
+    constexpr std::uint8_t surrogate = 1 << 4;
+    constexpr std::uint8_t overlong_2 = 1 << 5;
+    constexpr std::uint8_t too_large_1000 = 1 << 6;
+    constexpr std::uint8_t overlong_4 = 1 << 6;
+    constexpr std::uint8_t two_conts = 1 << 7;
+    constexpr std::uint8_t carry = too_short | too_long | two_conts;
+
+    alignas(16) constexpr std::uint8_t byte_1_high[16] = {
+        // 0_______: ASCII
+        too_long,
+        too_long,
+        too_long,
+        too_long,
+        too_long,
+        too_long,
+        too_long,
+        too_long,
+        // 10______: continuation
+        two_conts,
+        two_conts,
+        two_conts,
+        two_conts,
+        // 1100____, 1101____: two-byte lead
+        too_short | overlong_2,
+        too_short,
+        // 1110____: three-byte lead
+        too_short | overlong_3 | surrogate,
+        // 1111____: four-byte lead
+        too_short | too_large | too_large_1000 | overlong_4,
+    };
+
+    alignas(16) constexpr std::uint8_t byte_1_low[16] = {
+        carry | overlong_3 | overlong_2 | overlong_4, // ____0000
+        carry | overlong_2,                           // ____0001
+        carry,
+        carry,
+        carry | too_large, // ____0100
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000 | surrogate, // ____1101
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+    };
+
+    alignas(16) constexpr std::uint8_t byte_2_high[16] = {
+        // 0_______: ASCII
+        too_short,
+        too_short,
+        too_short,
+        too_short,
+        too_short,
+        too_short,
+        too_short,
+        too_short,
+        // 1000____
+        too_long | overlong_2 | two_conts | overlong_3 | too_large_1000
+            | overlong_4,
+        // 1001____
+        too_long | overlong_2 | two_conts | overlong_3 | too_large,
+        // 101_____
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        // 11______: lead
+        too_short,
+        too_short,
+        too_short,
+        too_short,
+    };
+
+    // Nonzero where the last bytes of a block start a sequence that the
+    // block does not finish.
+    alignas(32) constexpr std::uint8_t incomplete_max[32] = {
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf0 - 1, 0xe0 - 1, 0xc0 - 1,
+    };
+
+    inline auto has_ssse3() noexcept -> bool {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("ssse3") != 0;
+    }
+
+    // Error bits of `input` given the block before it.
+    __attribute__((target("ssse3"))) inline auto
+    utf8_errors_ssse3(__m128i input, __m128i prev_input) noexcept -> __m128i {
+        auto nibble = _mm_set1_epi8(0x0f);
+        auto prev1 = _mm_alignr_epi8(input, prev_input, 15);
+        auto table_1_high
+            = _mm_load_si128(reinterpret_cast<const __m128i *>(byte_1_high));
+        auto table_1_low
+            = _mm_load_si128(reinterpret_cast<const __m128i *>(byte_1_low));
+        auto table_2_high
+            = _mm_load_si128(reinterpret_cast<const __m128i *>(byte_2_high));
+        auto special = _mm_and_si128(
+            _mm_and_si128(
+                _mm_shuffle_epi8(
+                    table_1_high,
+                    _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                _mm_shuffle_epi8(table_1_low, _mm_and_si128(prev1, nibble))),
+            _mm_shuffle_epi8(table_2_high,
+                             _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+        // The second and third continuation bytes of three- and four-byte
+        // sequences, which the pair tables cannot see.
+        auto third = _mm_subs_epu8(_mm_alignr_epi8(input, prev_input, 14),
+                                   _mm_set1_epi8(0xe0 - 0x80));
+        auto fourth = _mm_subs_epu8(_mm_alignr_epi8(input, prev_input, 13),
+                                    _mm_set1_epi8(0xf0 - 0x80));
+        auto must_continue
+            = _mm_and_si128(_mm_or_si128(third, fourth),
+                            _mm_set1_epi8(static_cast<char>(0x80)));
+        return _mm_xor_si128(must_continue, special);
+    }
+
+    __attribute__((target("ssse3"))) inline auto
+    utf8_block_ssse3(const char *block,
+                     __m128i    &error,
+                     __m128i    &prev_input,
+                     __m128i    &prev_incomplete) noexcept -> void {
+        auto input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+        if (_mm_movemask_epi8(input) == 0) {
+            error = _mm_or_si128(error, prev_incomplete);
+        } else {
+            error = _mm_or_si128(error, utf8_errors_ssse3(input, prev_input));
+            prev_incomplete = _mm_subs_epu8(
+                input,
+                _mm_loadu_si128(
+                    reinterpret_cast<const __m128i *>(incomplete_max + 16)));
+        }
+        prev_input = input;
+    }
+
+    __attribute__((target("ssse3"))) inline auto
+    is_valid_utf8_ssse3(const char *first, const char *last) noexcept
+        -> bool {
+        auto error = _mm_setzero_si128();
+        auto prev_input = _mm_setzero_si128();
+        auto prev_incomplete = _mm_setzero_si128();
+        for (; last - first >= 16; first += 16) {
+            utf8_block_ssse3(first, error, prev_input, prev_incomplete);
+        }
+        // The tail is padded with zeros, so an empty tail still checks
+        // whether the last full block ended mid-sequence.
+        char tail[16] = {};
+        std::memcpy(tail, first, static_cast<std::size_t>(last - first));
+        utf8_block_ssse3(tail, error, prev_input, prev_incomplete);
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128()))
+               == 0xffff;
+    }
+
+    __attribute__((target("avx2"))) inline auto
+    utf8_errors_avx2(__m256i input, __m256i prev_input) noexcept -> __m256i {
+        auto nibble = _mm256_set1_epi8(0x0f);
+        // The previous bytes straddle the two 128-bit lanes.
+        auto carried = _mm256_permute2x128_si256(prev_input, input, 0x21);
+        auto prev1 = _mm256_alignr_epi8(input, carried, 15);
+        auto table_1_high = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i *>(byte_1_high)));
+        auto table_1_low = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i *>(byte_1_low)));
+        auto table_2_high = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i *>(byte_2_high)));
+        auto special = _mm256_and_si256(
+            _mm256_and_si256(
+                _mm256_shuffle_epi8(
+                    table_1_high,
+                    _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                _mm256_shuffle_epi8(table_1_low,
+                                    _mm256_and_si256(prev1, nibble))),
+            _mm256_shuffle_epi8(
+                table_2_high,
+                _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+        auto third = _mm256_subs_epu8(_mm256_alignr_epi8(input, carried, 14),
+                                      _mm256_set1_epi8(0xe0 - 0x80));
+        auto fourth = _mm256_subs_epu8(_mm256_alignr_epi8(input, carried, 13),
+                                       _mm256_set1_epi8(0xf0 - 0x80));
+        auto must_continue
+            = _mm256_and_si256(_mm256_or_si256(third, fourth),
+                               _mm256_set1_epi8(static_cast<char>(0x80)));
+        return _mm256_xor_si256(must_continue, special);
+    }
+
+    __attribute__((target("avx2"))) inline auto
+    utf8_block_avx2(const char *block,
+                    __m256i    &error,
+                    __m256i    &prev_input,
+                    __m256i    &prev_incomplete) noexcept -> void {
+        auto input
+            = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+        if (_mm256_movemask_epi8(input) == 0) {
+            error = _mm256_or_si256(error, prev_incomplete);
+        } else {
+            error = _mm256_or_si256(error, utf8_errors_avx2(input, prev_input));
+            prev_incomplete = _mm256_subs_epu8(
+                input,
+                _mm256_load_si256(
+                    reinterpret_cast<const __m256i *>(incomplete_max)));
+        }
+        prev_input = input;
+    }
+
+    __attribute__((target("avx2"))) inline auto
+    is_valid_utf8_avx2(const char *first, const char *last) noexcept -> bool {
+        auto error = _mm256_setzero_si256();
+        auto prev_input = _mm256_setzero_si256();
+        auto prev_incomplete = _mm256_setzero_si256();
+        for (; last - first >= 32; first += 32) {
+            utf8_block_avx2(first, error, prev_input, prev_incomplete);
+        }
+        char tail[32] = {};
+        std::memcpy(tail, first, static_cast<std::size_t>(last - first));
+        utf8_block_avx2(tail, error, prev_input, prev_incomplete);
+        return _mm256_testz_si256(error, error) != 0;
+    }
+#endif
+
+    inline auto select_is_valid_utf8() noexcept -> validate_fn {
+#if JSONLIB_SIMD_X86
+        if (has_avx2()) {
+            return is_valid_utf8_avx2;
+        }
+        if (has_ssse3()) {
+            return is_valid_utf8_ssse3;
+        }
+#endif
+        return is_valid_utf8_scalar;
+    }
+} // namespace detail
+
+// Whether [first, last) is well-formed UTF-8.
+inline auto is_valid_utf8(const char *first, const char *last) noexcept
+    -> bool {
+    static const detail::validate_fn impl = detail::select_is_valid_utf8();
+    return impl(first, last);
+}
+
+// The first byte of the first ill-formed sequence in [first, last), or
+// `last`. Scalar: meant for locating an error once `is_valid_utf8` failed.
+constexpr auto find_invalid_utf8(const char *first, const char *last) noexcept
+    -> const char * {
+    return detail::find_invalid_utf8_scalar(first, last);
+}
+
+} // namespace jsonlib::simd
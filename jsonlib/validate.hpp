@@ -0,0 +1,226 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include "jsonlib/parse_error.hpp"
+#include "jsonlib/simd.hpp"
+#include "jsonlib/tokenizer.hpp"
+#include "jsonlib/utf8.hpp"
+
+namespace jsonlib::detail {
+
+// Walks a document with the parser's tokenizer and checks it against the
+// RFC 8259 grammar, building nothing. Where the parser is lenient, this is
+// not: numbers must not have leading zeros, escapes must be one of \" \\ \/
+// \b \f \n \r \t \uXXXX and strings must not contain raw control
+// characters.
+class Validator {
+public:
+    Validator(std::string_view in, std::size_t max_depth) noexcept
+        : in_{in}
+        , max_depth_{max_depth} {}
+
+    // The first grammar error, or one of kind None.
+    auto run() noexcept -> ParseError {
+        if (value()) {
+            eat_whitespace(in_, pos_);
+            if (pos_ != in_.length()) [[unlikely]] {
+                fail(ParseError::Kind::TrailingCharacters);
+            }
+        }
+        return error_;
+    }
+
+private:
+    [[gnu::cold]] auto fail(ParseError::Kind kind) noexcept -> bool {
+        error_ = {kind, pos_};
+        return false;
+    }
+
+    auto literal(std::string_view text) noexcept -> bool {
+        return expect_literal(in_, pos_, text)
+               || fail(ParseError::Kind::InvalidLiteral);
+    }
+
+    auto value() noexcept -> bool {
+        eat_whitespace(in_, pos_);
+        if (pos_ == in_.length()) [[unlikely]] {
+            return fail(ParseError::Kind::UnexpectedEnd);
+        }
+        switch (in_[pos_]) {
+        case 'n':
+            return literal("null");
+        case 't':
+            return literal("true");
+        case 'f':
+            return literal("false");
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9': {
+            auto start = pos_;
+            if (!skip_number(in_, pos_)) [[unlikely]] {
+                pos_ = start;
+                return fail(ParseError::Kind::InvalidNumber);
+            }
+            return true;
+        }
+        case '"':
+            return string();
+        case '[':
+            return array();
+        case '{':
+            return object();
+        default:
+            return fail(ParseError::Kind::UnexpectedCharacter);
+        }
+    }
+
+    // Skips the string opening at `pos_`. Runs of plain characters are
+    // skipped a block at a time; only escapes are looked at one by one.
+    auto string() noexcept -> bool {
+        using enum ParseError::Kind;
+        auto        start = pos_;
+        const auto *first = in_.data() + pos_ + 1;
+        const auto *last = in_.data() + in_.length();
+        while (true) {
+            const auto *special = simd::find_escape(first, last);
+            pos_ = static_cast<std::size_t>(special - in_.data());
+            if (special == last) [[unlikely]] {
+                pos_ = start;
+                return fail(UnterminatedString);
+            }
+            if (*special == '"') {
+                pos_++;
+                return true;
+            }
+            if (*special != '\\') [[unlikely]] {
+                return fail(ControlCharacter);
+            }
+            if (last - special < 2) [[unlikely]] {
+                pos_ = start;
+                return fail(UnterminatedString);
+            }
+            switch (special[1]) {
+            case '"':
+            case '\\':
+            case '/':
+            case 'b':
+            case 'f':
+            case 'n':
+            case 'r':
+            case 't':
+                first = special + 2;
+                break;
+            case 'u':
+                if (last - special < 6 || !is_hex(special[2])
+                    || !is_hex(special[3]) || !is_hex(special[4])
+                    || !is_hex(special[5])) [[unlikely]] {
+                    return fail(InvalidEscape);
+                }
+                first = special + 6;
+                break;
+            default:
+                return fail(InvalidEscape);
+            }
+        }
+    }
+
+    static auto is_hex(char c) noexcept -> bool {
+        return ('0' <= c && c <= '9') || ('a' <= c && c <= 'f')
+               || ('A' <= c && c <= 'F');
+    }
+
+    auto array() noexcept -> bool {
+        using enum ParseError::Kind;
+        if (depth_ == max_depth_) [[unlikely]] {
+            return fail(TooDeep);
+        }
+        depth_++;
+        pos_++;
+        if (!consume(in_, pos_, ']')) {
+            do {
+                if (!value()) [[unlikely]] {
+                    return false;
+                }
+            } while (consume(in_, pos_, ','));
+            if (pos_ == in_.length() || in_[pos_] != ']') [[unlikely]] {
+                return fail(pos_ == in_.length() ? UnexpectedEnd
+                                                 : ExpectedCommaOrBracket);
+            }
+            pos_++;
+        }
+        depth_--;
+        return true;
+    }
+
+    auto object() noexcept -> bool {
+        using enum ParseError::Kind;
+        if (depth_ == max_depth_) [[unlikely]] {
+            return fail(TooDeep);
+        }
+        depth_++;
+        pos_++;
+        if (!consume(in_, pos_, '}')) {
+            do {
+                eat_whitespace(in_, pos_);
+                if (pos_ == in_.length() || in_[pos_] != '"') [[unlikely]] {
+                    return fail(pos_ == in_.length() ? UnexpectedEnd
+                                                     : ExpectedKey);
+                }
+                if (!string()) [[unlikely]] {
+                    return false;
+                }
+                if (!consume(in_, pos_, ':')) [[unlikely]] {
+                    return fail(pos_ == in_.length() ? UnexpectedEnd
+                                                     : ExpectedColon);
+                }
+                if (!value()) [[unlikely]] {
+                    return false;
+                }
+            } while (consume(in_, pos_, ','));
+            if (pos_ == in_.length() || in_[pos_] != '}') [[unlikely]] {
+                return fail(pos_ == in_.length() ? UnexpectedEnd
+                                                 : ExpectedCommaOrBrace);
+            }
+            pos_++;
+        }
+        depth_--;
+        return true;
+    }
+
+    std::string_view in_;
+    std::size_t      pos_{0};
+    std::size_t      max_depth_;
+    std::size_t      depth_{0};
+    ParseError       error_;
+};
+
+// The first error in `in` as a JSON document, or one of kind None. The
+// grammar admits nothing but ASCII outside of strings, so UTF-8 only needs
+// checking up to where the grammar check stopped; that is done in one
+// vectorized pass and the offending byte is looked for only on failure.
+inline auto validate(std::string_view in, std::size_t max_depth) noexcept
+    -> ParseError {
+    auto error = Validator{in, max_depth}.run();
+    auto checked
+        = error.kind == ParseError::Kind::None ? in.length() : error.offset;
+    const auto *first = in.data();
+    const auto *last = in.data() + checked;
+    if (!simd::is_valid_utf8(first, last)) [[unlikely]] {
+        error = {ParseError::Kind::InvalidUtf8,
+                 static_cast<std::size_t>(
+                     simd::find_invalid_utf8(first, last) - first)};
+    }
+    return error;
+}
+
+} // namespace jsonlib::detail
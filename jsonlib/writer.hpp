@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "jsonlib/json_codec.hpp"
+#include "jsonlib/simd.hpp"
+
+namespace jsonlib {
+
+// Sinks the serializer writes to. A writer takes single characters and runs
+// of characters; anything providing `put` and `write` can be used.
+template <typename W>
+concept Writer = requires(W &out, char c, std::string_view str) {
+    out.put(c);
+    out.write(str);
+};
+
+// Appends to a caller-owned string, so one buffer can be reused across many
+// serializations.
+template <typename String = std::string>
+class StringWriter {
+public:
+    explicit StringWriter(String &out) noexcept
+        : out_{&out} {}
+
+    auto put(char c) -> void {
+        out_->push_back(c);
+    }
+
+    auto write(std::string_view str) -> void {
+        out_->append(str.data(), str.size());
+    }
+
+private:
+    String *out_;
+};
+
+// Fills a fixed caller-provided buffer and never allocates. Output that does
+// not fit is dropped and reported by `overflowed()`.
+class BufferWriter {
+public:
+    explicit BufferWriter(std::span<char> buffer) noexcept
+        : buffer_{buffer} {}
+
+    auto put(char c) noexcept -> void {
+        if (size_ < buffer_.size()) {
+            buffer_[size_++] = c;
+        } else {
+            overflowed_ = true;
+        }
+    }
+
+    auto write(std::string_view str) noexcept -> void {
+        auto n = std::min(str.size(), buffer_.size() - size_);
+        std::copy_n(str.data(), n, buffer_.data() + size_);
+        size_ += n;
+        overflowed_ |= n != str.size();
+    }
+
+    // What has been written so far.
+    auto view() const noexcept -> std::string_view {
+        return {buffer_.data(), size_};
+    }
+
+    auto size() const noexcept -> std::size_t {
+        return size_;
+    }
+
+    auto overflowed() const noexcept -> bool {
+        return overflowed_;
+    }
+
+private:
+    std::span<char> buffer_;
+    std::size_t     size_{0};
+    bool            overflowed_{false};
+};
+
+// Collects output in a small local buffer and hands it to an std::ostream
+// in large writes, instead of paying the stream's sentry per token.
+class StreamWriter {
+public:
+    static constexpr std::size_t buffer_size = 4096;
+
+    explicit StreamWriter(std::ostream &out) noexcept
+        : out_{&out} {}
+
+    StreamWriter(const StreamWriter &) = delete;
+    auto operator=(const StreamWriter &) -> StreamWriter & = delete;
+
+    ~StreamWriter() {
+        flush();
+    }
+
+    auto put(char c) -> void {
+        if (size_ == buffer_size) {
+            flush();
+        }
+        buffer_[size_++] = c;
+    }
+
+    auto write(std::string_view str) -> void {
+        if (str.size() > buffer_size - size_) {
+            flush();
+            if (str.size() >= buffer_size) {
+                out_->write(str.data(),
+                            static_cast<std::streamsize>(str.size()));
+                return;
+            }
+        }
+        std::copy_n(str.data(), str.size(), buffer_ + size_);
+        size_ += str.size();
+    }
+
+    auto flush() -> void {
+        out_->write(buffer_, static_cast<std::streamsize>(size_));
+        size_ = 0;
+    }
+
+private:
+    std::ostream *out_;
+    std::size_t   size_{0};
+    char          buffer_[buffer_size];
+};
+
+namespace detail {
+    // Writes `str` as a quoted JSON string. Runs that need no escaping are
+    // located a block at a time and written in one piece.
+    template <Writer W>
+    auto write_escaped(W &out, std::string_view str) -> void {
+        const auto *first = str.data();
+        const auto *last = first + str.size();
+        out.put('"');
+        while (true) {
+            const auto *special = simd::find_escape(first, last);
+            out.write(std::string_view{first, special});
+            if (special == last) {
+                break;
+            }
+            out.write(json_encode[static_cast<unsigned char>(*special)]);
+            first = special + 1;
+        }
+        out.put('"');
+    }
+
+    template <Writer W>
+    auto write_number(W &out, std::int64_t value) -> void {
+        char buffer[24];
+        auto last = std::to_chars(buffer, std::end(buffer), value).ptr;
+        out.write(std::string_view{buffer, last});
+    }
+
+    template <Writer W>
+    auto write_number(W &out, std::uint64_t value) -> void {
+        char buffer[24];
+        auto last = std::to_chars(buffer, std::end(buffer), value).ptr;
+        out.write(std::string_view{buffer, last});
+    }
+
+    // Integral doubles below 2^53 take the integer path of std::to_chars;
+    // other doubles get the shortest representation that reads back to the
+    // same value. JSON has no NaN or infinity, so those are written as null.
+    template <Writer W>
+    auto write_number(W &out, double value) -> void {
+        constexpr double exact_limit = 0x1p53;
+        if (!std::isfinite(value)) {
+            out.write("null");
+            return;
+        }
+        // -0.0 keeps its sign through the double path.
+        if (std::abs(value) < exact_limit && value == std::trunc(value)
+            && (value != 0 || !std::signbit(value))) {
+            write_number(out, static_cast<std::int64_t>(value));
+            return;
+        }
+        // Enough for the longest shortest-round-trip double
+        // ("-2.2250738585072014e-308").
+        char buffer[32];
+        auto last = std::to_chars(buffer, std::end(buffer), value).ptr;
+        out.write(std::string_view{buffer, last});
+    }
+} // namespace detail
+
+} // namespace jsonlib
@@ -1,5 +1,24 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+
 #include "jsonlib/debug.hpp"
+#include "jsonlib/document.hpp"
 #include "jsonlib/jsonlib.hpp"
+#include "jsonlib/lazy.hpp"
+#include "jsonlib/mapped_file.hpp"
+#include "jsonlib/ndjson.hpp"
+#include "jsonlib/parallel.hpp"
+#include "jsonlib/sax.hpp"
+#include "jsonlib/static_json.hpp"
+#include "jsonlib/stream_parser.hpp"
+#include "jsonlib/structural_index.hpp"
 
 using namespace jsonlib;
 
@@ -39,6 +58,23 @@ auto test_number() {
     ASSERT(json_string2 == obj2.serialize());
 }
 
+auto test_number_kinds() {
+    std::string json_string = "[9223372036854775807, -9223372036854775808, "
+                              "18446744073709551615, 1e10, -2.5E-3, 0]";
+
+    auto obj = Json::deserialize(json_string);
+    LOG_INFO("obj.serialize(): {}", obj.serialize());
+    ASSERT(obj == Json({INT64_MAX, INT64_MIN, UINT64_MAX, 1e10, -2.5e-3, 0}));
+    ASSERT(Json::deserialize("9007199254740993").int64() == 9007199254740993);
+    ASSERT(Json::deserialize("18446744073709551615").uint64() == UINT64_MAX);
+    // integers beyond 64 bits and out of range doubles still parse
+    ASSERT(Json::deserialize("18446744073709551616").number() == 0x1p64);
+    ASSERT(Json::deserialize("-1e400").number()
+           == -std::numeric_limits<double>::infinity());
+    ASSERT(Json::deserialize("1e-400").number() == 0.0);
+    ASSERT(Json::deserialize("1") == Json::deserialize("1.0"));
+}
+
 auto test_string() {
     std::string json_string = R"("hello world")";
 
@@ -56,6 +92,57 @@ auto test_string_with_escaped_char() {
     ASSERT(obj.string() == R"(hello\r\n world\r\n)");
 }
 
+auto test_string_with_escaped_quote() {
+    std::string json_string
+        = R"(["say \"hi\"", "a long string that spans \"several\" blocks\\"])";
+
+    auto obj = Json::deserialize(json_string);
+    LOG_INFO("obj.serialize(): {}", obj.serialize());
+    ASSERT(json_string == obj.serialize());
+}
+
+auto test_unicode_escapes() {
+    std::string json_string
+        = R"(["caf\u00e9", "\u4F60\u597D", "\ud83d\ude00", "\ud83d!", "\uZZ"])";
+
+    auto obj = Json::deserialize(json_string);
+    LOG_INFO("obj.serialize(): {}", obj.serialize());
+    // lone surrogates become U+FFFD, malformed escapes are kept
+    ASSERT(obj == Json({"café", "你好", "😀", "\xef\xbf\xbd!", "\\uZZ"}));
+
+    // the decoded form is never longer, so a buffer can be decoded in place
+    std::string buffer = R"(tab\t, quote\", euro \u20ac, clef \ud834\udd1e)";
+    auto       *end = json_decode(buffer, buffer.data());
+    buffer.resize(static_cast<std::size_t>(end - buffer.data()));
+    ASSERT(buffer == "tab\t, quote\", euro €, clef 𝄞");
+    ASSERT(json_decode(R"(a\/b\\c)") == R"(a/b\c)");
+}
+
+auto test_borrowed_strings() {
+    std::string json_string = R"({"plain": "hello world", "tab": "a\tb"})";
+
+    auto obj = Json::deserialize(json_string, {.borrow_strings = true});
+    LOG_INFO("obj.serialize(): {}", obj.serialize());
+    ASSERT(json_string == obj.serialize());
+    // strings without escapes point into the input, the others are decoded
+    ASSERT(obj["plain"].string().data()
+           == json_string.data() + json_string.find("hello"));
+    ASSERT(obj["tab"].string() == "a\tb");
+    ASSERT(obj == Json::deserialize(json_string));
+}
+
+auto test_whitespace() {
+    std::string json_string = std::string(40, ' ')
+                              + "\t{\r\n\t\"array\" :\t[ 1 ,\n 2 ] ,"
+                                R"( "empty" : [ ] ,"object":{ })"
+                              + std::string(70, '\n') + "}\t";
+
+    auto obj = Json::deserialize(json_string);
+    LOG_INFO("obj.serialize(): {}", obj.serialize());
+    ASSERT(obj.serialize()
+           == R"({"array": [1, 2], "empty": [], "object": {}})");
+}
+
 auto test_array() {
     std::string json_string = R"(["R", "G", "B"])";
 
@@ -128,13 +215,556 @@ auto test_complex() {
     ASSERT((int) obj["Max Values Per Block"].number() == 50000);
 }
 
+auto test_document() {
+    std::string json_string = R"({"pi": 3.14, "rgb": ["R", "G", "B"]})";
+
+    auto doc = Document::parse(json_string);
+    LOG_INFO("doc.serialize(): {}", doc.serialize());
+    ASSERT(json_string == doc.serialize());
+    ASSERT(doc["pi"].number() == 3.14);
+
+    auto moved = std::move(doc);
+    ASSERT(moved["rgb"].serialize() == R"(["R", "G", "B"])");
+}
+
+auto test_stream_parser() {
+    std::string json_string = R"( {"id": 18446744073709551615, "pi": -3.14e-2,)"
+                              R"( "ok": [true, false, null, {}, []],)"
+                              R"( "msg": "say \"hi\" \u00e9\ud83d\ude00"} )";
+    auto expected = Json::deserialize(json_string);
+
+    // every split position, including inside tokens and escapes
+    for (std::size_t size = 1; size <= json_string.size(); size++) {
+        StreamParser parser;
+        for (std::size_t pos = 0; pos < json_string.size(); pos += size) {
+            parser.feed(std::string_view{json_string}.substr(pos, size));
+        }
+        ASSERT(parser.finish());
+        ASSERT(parser.release() == expected);
+    }
+
+    // a top-level number is only complete at the end of the input
+    StreamParser number;
+    ASSERT(!number.feed("12"));
+    ASSERT(!number.feed("34"));
+    ASSERT(number.finish() && number.release() == Json(1234));
+
+    // malformed input is rejected wherever the chunks split it
+    using enum ParseError::Kind;
+    auto error_of = [](std::string_view json_string, std::size_t size) {
+        StreamParser parser;
+        for (std::size_t pos = 0; pos < json_string.size(); pos += size) {
+            parser.feed(json_string.substr(pos, size));
+        }
+        ASSERT(!parser.finish() && parser.failed());
+        return parser.error();
+    };
+    for (std::size_t size = 1; size <= 8; size++) {
+        ASSERT(error_of("[:]", size).kind == UnexpectedCharacter);
+        ASSERT(error_of("[,1]", size).kind == UnexpectedCharacter);
+        ASSERT(error_of(R"({"a":,})", size).kind == UnexpectedCharacter);
+        ASSERT(error_of("1,", size).kind == TrailingCharacters);
+        ASSERT(error_of(R"("a":)", size).kind == TrailingCharacters);
+        ASSERT(error_of("{1:2}", size).kind == ExpectedKey);
+        ASSERT(error_of("[1}", size).kind == ExpectedCommaOrBracket);
+        ASSERT(error_of(R"({"a":1])", size).kind == ExpectedCommaOrBrace);
+        ASSERT(error_of(R"({"a" 1})", size).kind == ExpectedColon);
+        ASSERT(error_of("[1.5.5]", size).kind == InvalidNumber);
+        ASSERT(error_of("[truex]", size).kind == InvalidLiteral);
+        ASSERT(error_of(R"(["abc)", size).kind == UnterminatedString);
+        ASSERT(error_of("[1, 2", size).kind == UnexpectedEnd);
+    }
+    ASSERT(error_of(R"({"a": [1, 2}})", 3).offset == 11);
+
+    // nesting is limited as in the regular parser, however the input is split
+    auto deep = std::string(1000000, '[') + std::string(1000000, ']');
+    ASSERT(error_of(deep, 4096).kind == TooDeep);
+    ASSERT(error_of(deep, 4096).offset == 1024);
+    StreamParser shallow{ParseOptions{.max_depth = 2}};
+    ASSERT(shallow.feed("[[1], {\"a\": [") == false && shallow.failed());
+    ASSERT(shallow.error().kind == TooDeep && shallow.error().offset == 12);
+}
+
+auto test_events() {
+    std::string json_string = R"({"name": "caf\u00e9", "ids": [1, -2, 2.5],)"
+                              R"( "ok": true, "none": null, "big": 1e400})";
+
+    // records every event as text
+    struct Recorder : EventHandler {
+        using EventHandler::on_number;
+
+        std::string events;
+
+        auto on_null() -> void {
+            events += "null ";
+        }
+        auto on_bool(bool value) -> void {
+            events += value ? "true " : "false ";
+        }
+        auto on_number(std::int64_t value) -> void {
+            events += "i" + std::to_string(value) + ' ';
+        }
+        auto on_number(double value) -> void {
+            events += "d" + Json(value).serialize() + ' ';
+        }
+        auto on_string(std::string_view value) -> void {
+            events += "s:" + std::string{value} + ' ';
+        }
+        auto on_key(std::string_view key) -> void {
+            events += "k:" + std::string{key} + ' ';
+        }
+        auto on_start_object() -> void {
+            events += "{ ";
+        }
+        auto on_end_object() -> void {
+            events += "} ";
+        }
+        auto on_start_array() -> void {
+            events += "[ ";
+        }
+        auto on_end_array() -> void {
+            events += "] ";
+        }
+    } recorder;
+
+    ASSERT(parse_events(json_string, recorder));
+    LOG_INFO("events: {}", recorder.events);
+    ASSERT(recorder.events
+           == "{ k:name s:café k:ids [ i1 i-2 d2.5 ] k:ok true k:none null "
+              "k:big dnull } ");
+
+    // a callback returning false stops the parse
+    struct FirstKey : EventHandler {
+        std::string key;
+
+        auto on_key(std::string_view k) -> bool {
+            key = k;
+            return false;
+        }
+    } first;
+
+    ParseError stopped;
+    ASSERT(!parse_events(json_string, first, stopped));
+    ASSERT(first.key == "name" && stopped.kind == ParseError::Kind::None);
+
+    // malformed input stops the parse and says where
+    using enum ParseError::Kind;
+    auto error_of = [](std::string_view json_string) {
+        EventHandler handler;
+        ParseError   error;
+        ASSERT(!parse_events(json_string, handler, error));
+        return error;
+    };
+    ASSERT(error_of("[[1").kind == UnexpectedEnd);
+    ASSERT(error_of(R"({"a":)").kind == UnexpectedEnd);
+    ASSERT(error_of("[1}").kind == ExpectedCommaOrBracket);
+    ASSERT(error_of(R"({"a" 1})").kind == ExpectedColon);
+    ASSERT(error_of("{1: 2}").kind == ExpectedKey);
+    ASSERT(error_of("[nul]").kind == InvalidLiteral);
+    ASSERT(error_of("[-]").kind == InvalidNumber);
+    ASSERT(error_of(R"(["a\"])").kind == UnterminatedString);
+    ASSERT(error_of("[,1]").kind == UnexpectedCharacter);
+    ASSERT(error_of("[1] 2").offset == 4);
+    ASSERT(error_of(std::string(2000, '[')).kind == TooDeep);
+    EventHandler handler;
+    ASSERT(!parse_events("[[1]]", handler, {.max_depth = 1}));
+}
+
+auto test_lazy() {
+    std::string json_string
+        = R"({"skip": {"deep": [1, "]}", {"x": "\"{"}]}, "user": )"
+          R"({"name": "caf\u00e9", "id": 18446744073709551615},)"
+          R"( "tags": ["a", "b", "c"], "ok\u0021": true, "none": null})";
+
+    auto doc = LazyJson::parse(json_string);
+    ASSERT(doc.is_object());
+    ASSERT(doc["user"]["name"].string() == "café");
+    ASSERT(doc["user"]["id"].uint64() == UINT64_MAX);
+    ASSERT(doc["tags"][2].string() == "c");
+    ASSERT(!doc["tags"][3].exists() && !doc["missing"]["x"].exists());
+    ASSERT(doc["ok!"].boolean() && doc["none"].is_null());
+    ASSERT(doc["skip"].raw() == R"({"deep": [1, "]}", {"x": "\"{"}]})");
+
+    std::string keys;
+    for (auto member : doc) {
+        keys += member.key() + ' ';
+    }
+    ASSERT(keys == "skip user tags ok! none ");
+
+    std::size_t count = 0;
+    for (auto tag : doc["tags"]) {
+        count += tag.is_string() ? 1 : 0;
+    }
+    ASSERT(count == 3);
+    ASSERT(doc["user"].materialize().value()
+           == Json::deserialize(doc["user"].raw()));
+
+    // truncated input: missing cursors and iteration that ends early
+    for (std::string_view cut : {R"({"a":1,)", R"({"a":)", R"({"a")", R"({"a)",
+                                 "[1, [2", R"(["x)", "[1,", "["}) {
+        auto        lazy = LazyJson::parse(cut);
+        std::size_t values = 0;
+        for (auto value : lazy) {
+            values += value.raw().empty() ? 0 : 1;
+        }
+        ASSERT(values <= 2);
+        ASSERT(!lazy["b"].exists() && !lazy[5].exists());
+        ASSERT(lazy.raw().size() == cut.size());
+    }
+    ASSERT(!LazyJson::parse(R"({"a":)")["a"].exists());
+    ASSERT(LazyJson::parse(R"({"a":1,)")["a"].int64() == 1);
+
+    // skipped values are only checked once materialized
+    auto malformed = LazyJson::parse("{\"a\": 1,\n \"b\": [1, tru]}");
+    ASSERT(malformed["a"].int64() == 1 && malformed["b"].exists());
+    auto error = malformed["b"].materialize().error();
+    ASSERT(error.kind == ParseError::Kind::InvalidLiteral);
+    ASSERT(error.offset == 19 && error.line == 2 && error.column == 11);
+    ASSERT(malformed["c"].materialize().error().kind
+           == ParseError::Kind::UnexpectedEnd);
+}
+
+auto test_structural_index() {
+    // Backslash runs of both parities, one of them straddling the first
+    // 64-byte block boundary.
+    std::string json_string = R"({"a\\": [1, -2.5e3, true],)"
+                              R"( "pad": ".................",)"
+                              R"( "b": "x\\\"y]", "c": null, "d": {}})";
+    ASSERT(json_string.substr(62, 4) == R"(\\\")");
+
+    auto index = StructuralIndex::build(json_string);
+    ASSERT(index.strings_closed());
+    std::string structural;
+    for (auto pos : index.positions()) {
+        structural += json_string[pos];
+    }
+    ASSERT(structural == R"({":[1,-,t],":",":",":n,":{}})");
+    ASSERT(Json::deserialize(json_string, index)
+           == Json::deserialize(json_string));
+    ASSERT(!StructuralIndex::build(R"(["open)").strings_closed());
+
+    using enum ParseError::Kind;
+    auto error_of = [](std::string_view json_string) {
+        auto result = Json::try_deserialize(
+            json_string, StructuralIndex::build(json_string));
+        ASSERT(!result.has_value());
+        return result.error();
+    };
+    ASSERT(error_of("[1.5.5]").kind == UnexpectedCharacter);
+    ASSERT(error_of("[1.5.5]").offset == 4);
+    ASSERT(error_of("[truex]").kind == UnexpectedCharacter);
+    ASSERT(error_of(R"({"a":1x})").kind == UnexpectedCharacter);
+    ASSERT(error_of("[1,2]]").kind == TrailingCharacters);
+    ASSERT(error_of(R"(["a"b])").kind == UnexpectedCharacter);
+    ASSERT(error_of(R"([1, "open)").kind == UnterminatedString);
+    ASSERT(error_of(R"([1, "open)").offset == 4);
+    ASSERT(error_of("").kind == UnexpectedEnd);
+    ASSERT(error_of("[,1]").kind == UnexpectedCharacter);
+    auto ok = Json::try_deserialize(json_string,
+                                    StructuralIndex::build(json_string));
+    ASSERT(ok.has_value() && *ok == Json::deserialize(json_string));
+}
+
+auto test_ndjson() {
+    std::string lines;
+    for (int i = 0; i < 1000; i++) {
+        lines += R"({"id": )" + std::to_string(i) + R"(, "tag": "t\n"})";
+        lines += i % 100 == 0 ? "\r\n\n  \n" : "\n";
+    }
+    lines += "[1, 2]";
+
+    auto values = parse_ndjson(lines, {.threads = 4, .chunk_records = 16});
+    ASSERT(values.size() == 1001);
+    for (int i = 0; i < 1000; i++) {
+        ASSERT(values[i].has_value());
+        ASSERT((*values[i])["id"].int64() == i);
+        ASSERT((*values[i])["tag"].string() == "t\n");
+    }
+    ASSERT(*values[1000] == Json::deserialize("[1, 2]"));
+
+    std::vector<int>         seen(1001);
+    std::atomic<std::size_t> total{0};
+    parse_ndjson(
+        lines,
+        [&](std::size_t index, ParseResult<Json> value) {
+            seen[index]++;
+            total += value->serialize().size();
+        },
+        {.threads = 3});
+    ASSERT(std::ranges::all_of(seen, [](int n) { return n == 1; }));
+    ASSERT(total > 0);
+
+    // each malformed line is reported on its own
+    using enum ParseError::Kind;
+    std::string mixed = "{\"a\": 1}\n{\"a\":\n\n[1] x\n  tru\n2";
+    auto        results = parse_ndjson(mixed);
+    ASSERT(results.size() == 5);
+    ASSERT(results[0].has_value() && results[4].has_value());
+    ASSERT(results[1].error().kind == UnexpectedEnd);
+    ASSERT(results[2].error().kind == TrailingCharacters);
+    ASSERT(results[2].error().offset == 4);
+    ASSERT(results[3].error().kind == InvalidLiteral);
+    ASSERT(results[3].error().column == 3);
+
+    std::atomic<std::size_t> failed{0};
+    parse_ndjson(mixed, [&](std::size_t index, ParseResult<Json> value) {
+        failed += !value.has_value() && index >= 1 && index <= 3 ? 1 : 0;
+    });
+    ASSERT(failed == 3);
+}
+
+auto test_parallel_array() {
+    std::string json_string = "[";
+    for (int i = 0; i < 500; i++) {
+        json_string += i == 0 ? "" : ", ";
+        json_string += R"({"id": )" + std::to_string(i)
+                       + R"(, "list": [[], {"a": "],\""}], "n": null})";
+    }
+    json_string += ", 7, \"x\"]";
+
+    auto obj = deserialize_parallel(json_string,
+                                    {.threads = 4, .chunk_records = 8});
+    ASSERT(obj == Json::deserialize(json_string));
+    ASSERT(deserialize_parallel("[]") == Json::deserialize("[]"));
+    ASSERT(deserialize_parallel(R"( {"a": [1, 2]} )")
+           == Json::deserialize(R"({"a": [1, 2]})"));
+    ASSERT(deserialize_parallel("[[1], 2]") == Json::deserialize("[[1], 2]"));
+
+    // the first error in document order, where the sequential parser
+    // finds it
+    for (std::string_view bad :
+         {"[1,]", "[,1]", "[1, 2 3]", "[1, [2}, 3]", "[1}", "[1, tru, x]",
+          "[1, 2]]", R"([{"a" 1}, 2])", "[1, 2.5.5, 3]", "[[1], [2"}) {
+        auto expected = Json::try_deserialize(bad);
+        auto result = try_deserialize_parallel(bad, {.chunk_records = 1});
+        ASSERT(!result.has_value() && !expected.has_value());
+        ASSERT(result.error().offset == expected.error().offset);
+    }
+    // elements are one level deep
+    auto depth = [](std::size_t max_depth) {
+        return BatchOptions{.parse = {.max_depth = max_depth}};
+    };
+    ASSERT(try_deserialize_parallel("[[1], [2]]", depth(2)).has_value());
+    ASSERT(!try_deserialize_parallel("[[1], [2]]", depth(1)).has_value());
+    ASSERT(!try_deserialize_parallel("[1]", depth(0)).has_value());
+}
+
+auto test_file() {
+    std::string json_string = R"({"name": "jsonlib", "list": [1, "two\n"]})";
+    std::string path = "test_json_deserialize.tmp.json";
+    {
+        std::ofstream out{path, std::ios::binary};
+        out << json_string;
+    }
+
+    auto obj = *deserialize_file(path);
+    ASSERT(obj == Json::deserialize(json_string));
+
+    MappedFile file{path};
+    ASSERT(file.is_open() && file.view() == json_string);
+    auto borrowed = Json::deserialize(file.view(), {.borrow_strings = true});
+    ASSERT(borrowed["name"].string().data() == file.view().data() + 10);
+    ASSERT(borrowed == obj);
+
+    {
+        std::ofstream out{path, std::ios::binary};
+        out << "[1, 2";
+    }
+    ASSERT(deserialize_file(path).error().kind
+           == ParseError::Kind::UnexpectedEnd);
+
+    std::remove(path.c_str());
+    ASSERT(!MappedFile{path}.is_open());
+    ASSERT(deserialize_file(path).error().kind
+           == ParseError::Kind::CannotOpenFile);
+}
+
+auto test_errors() {
+    using enum ParseError::Kind;
+    auto error_of = [](std::string_view json_string) {
+        auto result = Json::try_deserialize(json_string);
+        ASSERT(!result.has_value());
+        return result.error();
+    };
+
+    auto ok = Json::try_deserialize(R"( {"a": [1, "x", null]} )");
+    ASSERT(ok.has_value());
+    ASSERT((*ok)["a"] == Json::deserialize(R"([1, "x", null])"));
+
+    ASSERT(error_of("").kind == UnexpectedEnd);
+    ASSERT(error_of("  nul").kind == InvalidLiteral);
+    ASSERT(error_of("[1, -]").kind == InvalidNumber);
+    ASSERT(error_of("[1, -]").offset == 4);
+    ASSERT(error_of(R"(["abc)").kind == UnterminatedString);
+    ASSERT(error_of(R"({"a": 1,})").kind == ExpectedKey);
+    ASSERT(error_of(R"({"a" 1})").kind == ExpectedColon);
+    ASSERT(error_of("[1 2]").kind == ExpectedCommaOrBracket);
+    ASSERT(error_of(R"({"a": 1 "b": 2})").kind == ExpectedCommaOrBrace);
+    ASSERT(error_of("[1, 2").kind == UnexpectedEnd);
+    ASSERT(error_of("[1,]").kind == UnexpectedCharacter);
+    ASSERT(error_of("{} x").kind == TrailingCharacters);
+    ASSERT(error_of(std::string(2000, '[')).kind == TooDeep);
+
+    auto error = error_of("{\n  \"a\": [1,\n    tru]\n}");
+    ASSERT(error.kind == InvalidLiteral);
+    ASSERT(error.line == 3 && error.column == 5 && error.offset == 17);
+    LOG_INFO("{}:{}: {}", error.line, error.column, error.message());
+}
+
+auto test_validate() {
+    using enum ParseError::Kind;
+    auto error_of = [](std::string_view json_string) {
+        ParseError error;
+        ASSERT(!Json::validate(json_string, error));
+        return error;
+    };
+
+    ASSERT(Json::validate(R"( {"a": [0, -1.5e+3, true, null], "b": {}} )"));
+    ASSERT(Json::validate(R"(["\"\\\/\b\f\n\r\té😀"])"));
+    ASSERT(Json::validate("\"h\xc3\xa9llo \xe4\xb8\x96\xe7\x95\x8c "
+                          "\xf0\x9f\x98\x80\""));
+
+    ASSERT(error_of("").kind == UnexpectedEnd);
+    ASSERT(error_of("[01]").kind == InvalidNumber);
+    ASSERT(error_of("[01]").offset == 1);
+    ASSERT(error_of(R"(["\x"])").kind == InvalidEscape);
+    ASSERT(error_of(R"(["\u12g4"])").kind == InvalidEscape);
+    ASSERT(error_of("[\"a\tb\"]").kind == ControlCharacter);
+    ASSERT(error_of("[\"a\tb\"]").offset == 3);
+    ASSERT(error_of(R"({"a": 1,})").kind == ExpectedKey);
+    ASSERT(error_of("[1, 2").kind == UnexpectedEnd);
+    ASSERT(error_of("{} x").kind == TrailingCharacters);
+    ASSERT(error_of(std::string(2000, '[')).kind == TooDeep);
+
+    // overlong, surrogate, truncated
+    ASSERT(error_of("\"\xc0\xaf\"").kind == InvalidUtf8);
+    ASSERT(error_of("[\"\xed\xa0\x80\"]").offset == 2);
+    ASSERT(error_of("\"\xe4\xb8\"").kind == InvalidUtf8);
+    std::string long_string(100, 'x');
+    long_string[70] = '\xff';
+    ASSERT(error_of('"' + long_string + '"').offset == 71);
+
+    auto error = error_of("{\n  \"a\": [1,\n    tru]\n}");
+    ASSERT(error.kind == InvalidLiteral);
+    ASSERT(error.line == 3 && error.column == 5);
+}
+
+constexpr auto static_config = static_json<R"({
+    "retries": 3,
+    "timeout": 2.5,
+    "hosts": ["a.example", "b.example"],
+    "limits": {"max": 18446744073709551615, "min": -9223372036854775808},
+    "greeting": "héllo \"world\"",
+    "tls": true,
+    "proxy": null,
+    "ratio": 1.7976931348623157e308
+})">.root();
+
+// Checked by the compiler: nothing below is parsed at run time.
+static_assert(static_config["retries"].int64() == 3);
+static_assert(static_config["timeout"].number() == 2.5);
+static_assert(static_config["hosts"].size() == 2);
+static_assert(static_config["hosts"][1].string() == "b.example");
+static_assert(static_config["limits"]["max"].uint64()
+              == std::numeric_limits<std::uint64_t>::max());
+static_assert(static_config["limits"]["min"].int64()
+              == std::numeric_limits<std::int64_t>::min());
+static_assert(static_config["greeting"].string() == "h\xc3\xa9llo \"world\"");
+static_assert(static_config["tls"].boolean());
+static_assert(static_config["proxy"].is_null());
+static_assert(!static_config["missing"]["deeper"].exists());
+static_assert(!static_config["hosts"][2].exists());
+static_assert(static_config["ratio"].number()
+              == std::numeric_limits<double>::max());
+
+auto test_static_json() {
+    std::string keys;
+    for (auto member : static_config) {
+        keys += member.key();
+        keys += ' ';
+    }
+    ASSERT(keys == "retries timeout hosts limits greeting tls proxy ratio ");
+
+    // bit for bit what the compiler makes of the same literals, past the
+    // fast path too: long significands, subnormals, ties and overflow
+    constexpr auto numbers = static_json<
+        "[0.1, 1e-7, 123456.789e3, -0.0, 1e22, 5e-324, 1e23,"
+        " 0.30000000000000004, 2.2250738585072011e-308,"
+        " -2.4703282292062328e-324, 9007199254740993.0,"
+        " 1.00000000000000011102230246251565404236316680908203125,"
+        " 3.14159265358979323846264338327950288419716939937510582097494459,"
+        " 1e-400, 1.7976931348623158e308, 1.7976931348623159e308]">.root();
+    constexpr double expected[] = {
+        0.1,
+        1e-7,
+        123456.789e3,
+        -0.0,
+        1e22,
+        5e-324,
+        1e23,
+        0.30000000000000004,
+        2.2250738585072011e-308,
+        -2.4703282292062328e-324,
+        9007199254740993.0,
+        1.00000000000000011102230246251565404236316680908203125,
+        3.14159265358979323846264338327950288419716939937510582097494459,
+        0.0,
+        1.7976931348623157e308,
+        std::numeric_limits<double>::infinity(),
+    };
+    static_assert(numbers.size() == std::size(expected));
+    static_assert(std::bit_cast<std::uint64_t>(numbers[8].number())
+                  == std::bit_cast<std::uint64_t>(expected[8]));
+    for (std::size_t i = 0; i < numbers.size(); i++) {
+        ASSERT(std::bit_cast<std::uint64_t>(numbers[i].number())
+               == std::bit_cast<std::uint64_t>(expected[i]));
+    }
+}
+
+auto test_pmr() {
+    std::string json_string = R"({"pi": 3.14, "rgb": ["R", "G", "B"]})";
+
+    std::pmr::monotonic_buffer_resource resource;
+    // Anything that is not propagated would fall back to the default resource
+    // and throw.
+    auto *previous
+        = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+
+    auto obj = pmr::Json::deserialize(json_string, &resource);
+    obj["rule"]["work"] = "nine to nine, six days a week";
+    obj["copy"] = obj["rgb"];
+    std::pmr::set_default_resource(previous);
+
+    LOG_INFO("obj.serialize(): {}", obj.serialize());
+    ASSERT(obj.get_allocator().resource() == &resource);
+    ASSERT(obj["rule"]["work"].get_allocator().resource() == &resource);
+    ASSERT(obj["copy"] == obj["rgb"]);
+}
+
 auto main() -> int {
     test_null();
     test_boolean();
     test_number();
+    test_number_kinds();
     test_string();
     test_string_with_escaped_char();
+    test_string_with_escaped_quote();
+    test_unicode_escapes();
+    test_borrowed_strings();
+    test_whitespace();
     test_array();
     test_object();
     test_complex();
+    test_document();
+    test_stream_parser();
+    test_events();
+    test_lazy();
+    test_structural_index();
+    test_ndjson();
+    test_parallel_array();
+    test_file();
+    test_errors();
+    test_validate();
+    test_static_json();
+    test_pmr();
 }
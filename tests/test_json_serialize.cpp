@@ -1,3 +1,9 @@
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <sstream>
+
 #include "jsonlib/debug.hpp"
 #include "jsonlib/jsonlib.hpp"
 
@@ -29,14 +35,28 @@ auto test_number() {
     ASSERT_MSG(ret == R"({"number1": 1, "number2": 3.14})", "serialize error");
 }
 
+auto test_number_precision() {
+    Json obj = {0.1 + 0.2, 1e10, 1e300, -0.0, 2.5e-8, UINT64_MAX};
+    auto ret = obj.serialize();
+    LOG_INFO("`{}`", ret);
+    ASSERT(ret
+           == "[0.30000000000000004, 10000000000, 1e+300, -0, 2.5e-08, "
+              "18446744073709551615]");
+    ASSERT(Json::deserialize(ret) == obj);
+
+    Json special = {std::numeric_limits<double>::quiet_NaN(),
+                    std::numeric_limits<double>::infinity()};
+    ASSERT(special.serialize() == "[null, null]");
+}
+
 auto test_string() {
     Json obj;
     obj["hello"] = "world";
     obj["empty"] = "";
     auto ret = obj.serialize();
     LOG_INFO("`{}`", ret);
-    // NOTE: std::map sort by key
-    ASSERT_MSG(ret == R"({"empty": "", "hello": "world"})", "serialize error");
+    // NOTE: members keep their insertion order
+    ASSERT_MSG(ret == R"({"hello": "world", "empty": ""})", "serialize error");
 }
 
 auto test_string_with_escaped_char() {
@@ -47,6 +67,22 @@ auto test_string_with_escaped_char() {
     ASSERT(ret == R"({"with-escaped-char": "hello\t hello\r hello\n"})");
 }
 
+auto test_string_with_control_char() {
+    auto x = std::string(40, 'x');
+    auto y = std::string(40, 'y');
+
+    Json obj;
+    obj["key \"quoted\""] = std::string_view{"nul\0 bell\a esc\x1b", 15};
+    // long enough for the vectorized scan; '/' and UTF-8 are left alone
+    obj["long"] = x + "/é\\" + y + '\x1f';
+    auto ret = obj.serialize();
+    LOG_INFO("`{}`", ret);
+    ASSERT(ret
+           == R"({"key \"quoted\"": "nul\u0000 bell\u0007 esc\u001b", )"
+              R"("long": ")"
+                  + x + "/é\\\\" + y + R"(\u001f"})");
+}
+
 auto test_array() {
     Json obj;
     obj["array"] = {"R", "G", "B"};
@@ -69,23 +105,95 @@ auto test_object() {
     Json obj;
     Json nested_obj1;
     Json nested_obj2;
-    obj["level1"] = nested_obj1;
-    nested_obj1["level2"] = nested_obj2;
     nested_obj2["level3"] = Json();
+    nested_obj1["level2"] = nested_obj2;
+    obj["level1"] = nested_obj1;
     auto ret = obj.serialize();
     LOG_INFO("`{}`", ret);
     ASSERT_MSG(ret == R"({"level1": {"level2": {"level3": null}}})",
                "serialize error");
 }
 
+auto test_object_order() {
+    Json        obj;
+    std::string expected{"{"};
+    for (int i = 32; i > 0; i--) {
+        auto key = "key" + std::to_string(i);
+        obj[key] = i;
+        expected += '"' + key + "\": " + std::to_string(i);
+        expected += i > 1 ? ", " : "}";
+    }
+    obj["key16"] = "updated";
+    auto ret = obj.serialize();
+    LOG_INFO("`{}`", ret);
+    ASSERT(obj["key16"].string() == "updated");
+    ASSERT(obj["key1"].number() == 1);
+    ASSERT(ret.find(R"("key17": 17, "key16": "updated", "key15": 15)")
+           != std::string::npos);
+    obj["key16"] = 16;
+    ASSERT(obj.serialize() == expected);
+}
+
+auto test_object_stable_members() {
+    // a reference to a member must survive the object growing, including
+    // across the switch to an indexed lookup after 16 members
+    Json obj;
+    obj["a"] = 1;
+    obj["b"] = 2;
+    obj["c"] = 3;
+    obj["rgb"] = {"R", "G", "B"};
+    obj["copy"] = obj["rgb"];
+    ASSERT(obj["copy"].serialize() == R"(["R", "G", "B"])");
+
+    auto &first = obj["a"];
+    auto &rgb = obj["rgb"];
+    for (int i = 0; i < 64; i++) {
+        obj["key" + std::to_string(i)] = rgb;
+    }
+    first = "first";
+    ASSERT(obj["a"].string() == "first");
+    ASSERT(obj["key63"].serialize() == R"(["R", "G", "B"])");
+    ASSERT(obj.serialize().starts_with(R"({"a": "first", "b": 2, "c": 3)"));
+}
+
+auto test_writers() {
+    Json obj;
+    obj["rgb"] = {"R", "G", "B"};
+    obj["pi"] = 3.14;
+    std::string_view expected = R"({"rgb": ["R", "G", "B"], "pi": 3.14})";
+
+    // serialize_to appends, so a buffer can be reused
+    std::string reused = "> ";
+    obj.serialize_to(reused);
+    ASSERT(reused == "> " + std::string{expected});
+
+    std::ostringstream stream;
+    obj.serialize_to(stream);
+    ASSERT(stream.str() == expected);
+
+    std::array<char, 64> buffer{};
+    BufferWriter         fits{buffer};
+    obj.serialize_to(fits);
+    ASSERT(!fits.overflowed() && fits.view() == expected);
+
+    BufferWriter truncated{std::span{buffer}.first(8)};
+    obj.serialize_to(truncated);
+    ASSERT(truncated.overflowed() && truncated.view() == expected.substr(0, 8));
+}
+
 auto main() -> int {
     SET_LOG_STYLE(print_hpp::log::LogStyle::BG);
     test_null();
     test_bool();
     test_number();
+    test_number_precision();
     test_string();
     test_string_with_escaped_char();
+    test_string_with_control_char();
     test_array();
     test_array2();
     test_object();
+    test_object_order();
+    test_object_stable_members();
+    test_writers();
 }
@@ -0,0 +1,180 @@
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "jsonlib/debug.hpp"
+#include "jsonlib/jsonlib.hpp"
+#include "jsonlib/reflect.hpp"
+
+using namespace jsonlib;
+
+namespace shop {
+struct Item {
+    std::string name;
+    double      price;
+    int         quantity;
+};
+JSONLIB_REFLECT(Item, name, price, quantity)
+
+struct Order {
+    std::uint64_t              id;
+    bool                       paid;
+    std::vector<Item>          items;
+    std::optional<std::string> note;
+    std::map<std::string, int> totals;
+    Json                       extra;
+};
+JSONLIB_REFLECT(Order, id, paid, items, note, totals, extra)
+} // namespace shop
+
+struct Empty {};
+JSONLIB_REFLECT(Empty)
+
+// more fields than one seed can place without collisions
+struct Wide {
+    int f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14,
+        f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27,
+        f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40,
+        f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53,
+        f54, f55, f56, f57, f58, f59, f60, f61, f62, f63;
+};
+JSONLIB_REFLECT(Wide, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12,
+                f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25,
+                f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38,
+                f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51,
+                f52, f53, f54, f55, f56, f57, f58, f59, f60, f61, f62, f63)
+
+auto test_struct() {
+    shop::Item item{"tea \"green\"", 3.5, 2};
+    auto       ret = serialize(item);
+    LOG_INFO("`{}`", ret);
+    ASSERT(ret == R"({"name": "tea \"green\"", "price": 3.5, "quantity": 2})");
+}
+
+auto test_nested_struct() {
+    shop::Order order{
+        .id = 18446744073709551615ULL,
+        .paid = true,
+        .items = {{"tea", 3.5, 2}, {"cup", 12, 1}},
+        .note = std::nullopt,
+        .totals = {{"tea", 7}},
+        .extra = {1, "x"},
+    };
+    auto ret = serialize(order);
+    LOG_INFO("`{}`", ret);
+    ASSERT(ret
+           == R"({"id": 18446744073709551615, "paid": true, "items": )"
+              R"([{"name": "tea", "price": 3.5, "quantity": 2}, )"
+              R"({"name": "cup", "price": 12, "quantity": 1}], )"
+              R"("note": null, "totals": {"tea": 7}, "extra": [1, "x"]})");
+
+    // reads back the same as a Json built field by field
+    Json obj;
+    obj["id"] = order.id;
+    obj["paid"] = order.paid;
+    obj["note"] = nullptr;
+    ASSERT(Json::deserialize(ret)["id"] == obj["id"]);
+    ASSERT(Json::deserialize(ret)["note"] == obj["note"]);
+
+    order.note = "fragile";
+    ASSERT(Json::deserialize(serialize(order))["note"].string()
+           == "fragile");
+}
+
+auto test_struct_writers() {
+    ASSERT(serialize(Empty{}) == "{}");
+
+    std::string out = "[";
+    serialize_to(out, shop::Item{"a", 0.5, 1});
+    ASSERT(out == R"([{"name": "a", "price": 0.5, "quantity": 1})");
+
+    char         buffer[16];
+    BufferWriter writer{buffer};
+    serialize_to(writer, shop::Item{"a", 0.5, 1});
+    ASSERT(writer.overflowed());
+
+    std::ostringstream stream;
+    {
+        StreamWriter stream_writer{stream};
+        serialize_to(stream_writer, std::vector<int>{1, 2, 3});
+    }
+    ASSERT(stream.str() == "[1, 2, 3]");
+}
+
+auto test_read() {
+    auto item = read<shop::Item>(
+        R"({"quantity": 2, "unknown": {"a": [1, "}"]}, "name": "t\u00e9a",)"
+        R"( "price": 3.5})");
+    ASSERT(item.name == "t\u00e9a");
+    ASSERT(item.price == 3.5 && item.quantity == 2);
+
+    // what serialize writes reads back into the same values
+    shop::Order order{
+        .id = 18446744073709551615ULL,
+        .paid = true,
+        .items = {{"tea", 3.5, 2}, {"cup", 12, 1}},
+        .note = "fragile",
+        .totals = {{"tea", 7}, {"c\"up", 12}},
+        .extra = {1, "x"},
+    };
+    auto copy = read<shop::Order>(serialize(order));
+    ASSERT(copy.id == order.id && copy.paid);
+    ASSERT(copy.items.size() == 2 && copy.items[1].name == "cup");
+    ASSERT(copy.note == "fragile");
+    ASSERT(copy.totals == order.totals);
+    ASSERT(copy.extra == order.extra);
+    ASSERT(serialize(copy) == serialize(order));
+
+    ASSERT(!read<shop::Order>(R"({"note": null})").note.has_value());
+    ASSERT((read<std::vector<double>>("[1, -2.5, 3e2]")
+            == std::vector<double>{1, -2.5, 300}));
+    ASSERT(read<std::uint8_t>("255") == 255);
+
+    // a repeated key replaces containers read earlier, as for scalars
+    auto repeated = read<shop::Order>(
+        R"({"totals": {"old": 1, "tea": 2}, "items": [{"name": "a"}],)"
+        R"( "totals": {"tea": 7}, "items": []})");
+    ASSERT((repeated.totals == std::map<std::string, int>{{"tea", 7}}));
+    ASSERT(repeated.items.empty());
+    ASSERT(serialize(read<Empty>(R"({"a": [1]})")) == "{}");
+
+    Wide wide{};
+    wide.f0 = 1;
+    wide.f31 = 32;
+    wide.f63 = 64;
+    auto wide_copy = read<Wide>(serialize(wide));
+    ASSERT(wide_copy.f0 == 1 && wide_copy.f31 == 32 && wide_copy.f63 == 64);
+    ASSERT(serialize(wide_copy) == serialize(wide));
+    wide_copy = read<Wide>(R"({"f17": 18, "f64": 1, "f": 2, "f40": 41})");
+    ASSERT(wide_copy.f17 == 18 && wide_copy.f40 == 41 && wide_copy.f0 == 0);
+}
+
+auto test_read_errors() {
+    using enum ParseError::Kind;
+    auto error_of = [](std::string_view json_string) {
+        auto result = try_read<shop::Order>(json_string);
+        ASSERT(!result.has_value());
+        return result.error();
+    };
+
+    ASSERT(try_read<shop::Item>(R"({"name": "a"})").has_value());
+    ASSERT(error_of("").kind == UnexpectedEnd);
+    ASSERT(error_of("[]").kind == UnexpectedType);
+    ASSERT(error_of(R"({"id": -1})").kind == UnexpectedType);
+    ASSERT(error_of(R"({"id": 1.5})").kind == UnexpectedType);
+    ASSERT(error_of(R"({"paid": 1})").kind == UnexpectedType);
+    ASSERT(error_of(R"({"items": [{"name": 1}]})").offset == 20);
+    ASSERT(error_of(R"({"other": [1, 2})").kind == ExpectedCommaOrBracket);
+    ASSERT(error_of(R"({"id": 1} x)").kind == TrailingCharacters);
+    ASSERT(try_read<std::uint8_t>("256").error().kind == UnexpectedType);
+}
+
+auto main() -> int {
+    test_struct();
+    test_nested_struct();
+    test_struct_writers();
+    test_read();
+    test_read_errors();
+}